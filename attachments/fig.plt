@@ -1,17 +1,23 @@
+# Figuras de escalabilidad a partir de los resultados de 'src/benchmark/compiler_benchmark.sh'.
+# 'speedup.dat' y 'weak.dat' contienen un bloque por configuración; la primera línea de cada bloque es el título de la leyenda.
+# Columnas: trabajadores (procesos x hilos), speedup, eficiencia, tiempo mediano, tiempo mínimo, procesos, hilos.
+
 set terminal epslatex color size 6.0in,5.0in standalone font "" 14
 set output 'Figure.tex'
 
 set border linewidth 6 
 
 set ylabel '\textbf{Speedup} $S$'
-set xlabel '\textbf{Número de hilos} $P$'
+set xlabel '\textbf{Número de trabajadores} $P$'
 
 set ytics scale 2
 set xtics scale 2
+set key left top
 
 f(x) = x
 
-plot 'speedup.dat' u 1:2 w p pt 7 ps 2.5 lc rgb "red" t 'Escalabilidad \texttt{Capacitor Wavefront}',\
+# Escalabilidad fuerte: factor de escala fijo.
+plot for [i=0:*] 'speedup.dat' index i u 1:2 w lp pt 7 ps 2.5 lw 3 t columnheader(1),\
      f(x) w l lw 3 lc rgb "red" t 'Escalabilidad Lineal'
 
 set output
@@ -19,3 +25,20 @@ system('latex Figure.tex')
 system('dvips Figure.dvi')
 system('ps2pdf Figure.ps')
 system('rm Figure.tex Figure.log Figure.aux Figure-inc.eps Figure.dvi Figure.ps')
+
+# Escalabilidad débil: entradas por trabajador constantes; la eficiencia compara el tiempo por iteración.
+if (strstrt(system('test -f weak.dat && echo si'), 'si') > 0) {
+  set output 'Weak.tex'
+  set ylabel '\textbf{Eficiencia} $E$'
+  set yrange [0:1.2]
+  set key left bottom
+
+  plot for [i=0:*] 'weak.dat' index i u 1:3 w lp pt 7 ps 2.5 lw 3 t columnheader(1),\
+       1 w l lw 3 lc rgb "red" t 'Escalabilidad Ideal'
+
+  set output
+  system('latex Weak.tex')
+  system('dvips Weak.dvi')
+  system('ps2pdf Weak.ps')
+  system('rm Weak.tex Weak.log Weak.aux Weak-inc.eps Weak.dvi Weak.ps')
+}
@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+
+# Banco de pruebas común para los tres solucionadores (serial, memoria compartida y memoria distribuida).
+# Ejecuta cada combinación de variante, factor de escala, omega, kernel, hilos y procesos varias veces (con ejecuciones de calentamiento descartadas),
+# y escribe los resultados en archivos de texto que 'attachments/fig.plt' grafica directamente:
+#   - 'benchmark.dat': una fila por combinación con todas las mediciones.
+#   - 'speedup.dat': escalabilidad fuerte (factor fijo), un bloque por configuración.
+#   - 'weak.dat': escalabilidad débil (entradas por trabajador constantes), un bloque por configuración.
+# Con 'auto' en '--omegas' los solucionadores escogen omega con 'omega_tuning.h'; al final se reporta el ahorro de iteraciones respecto de cada omega fijo.
+# Los ejecutables se compilan con 'compiler_benchmark.sh'. Los solucionadores se ejecutan con la opción '--benchmark', que reporta el tiempo y las iteraciones sin imprimir la grilla.
+
+import argparse
+import math
+import os
+import re
+import shlex
+import statistics
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# Variantes disponibles por solucionador y argumentos correspondientes de cada ejecutable.
+VARIANTS = {
+    'serial': {'gauss_seidel': ['gauss_seidel'], 'simd': ['simd'], 'simd_simple': ['simd', '--aritmetica', 'simple'],
+               'simd_mixta': ['simd', '--aritmetica', 'mixta'], 'simd_temporal': ['simd', '--bloque-temporal', '4'],
+               'multigrid': ['multigrid'], 'fmg': ['fmg']},
+    'openmp': {'wavefront': ['wavefront'], 'redblack': ['redblack'], 'simd': ['simd'], 'simd_temporal': ['simd', '--bloque-temporal', '4'], 'tiled': ['tiled'],
+               'multigrid': ['multigrid'], 'fmg': ['fmg'], 'pcg': ['pcg']},
+    'mpi': {'filas': [], 'simd': [], 'solapado': ['--solapado'], 'cartesiano': ['--cartesiano'], 'hibrido': ['--hibrido'], 'pcg': ['--pcg']},
+}
+# Variantes que emplean los kernels de 'stencil_kernel.h'.
+KERNEL_VARIANTS = {('serial', 'simd'), ('serial', 'simd_simple'), ('serial', 'simd_mixta'), ('serial', 'simd_temporal'), ('openmp', 'simd'), ('openmp', 'simd_temporal'),
+                   ('mpi', 'simd'), ('mpi', 'hibrido')}
+
+# Modelo de tráfico de memoria: una lectura y una escritura de 8 bytes por entrada actualizada (las entradas vecinas se reutilizan desde la caché).
+# Las variantes en simple precisión mueven 4 bytes por lectura y escritura.
+BYTES_PER_UPDATE = 16
+SINGLE_PRECISION_VARIANTS = {('serial', 'simd_simple'), ('serial', 'simd_mixta')}
+# Las variantes con bloqueo temporal ('--bloque-temporal 4') recorren la grilla en memoria una vez cada 4 iteraciones.
+TEMPORAL_DEPTH = {('serial', 'simd_temporal'): 4, ('openmp', 'simd_temporal'): 4}
+
+
+def parse_list(text, kind=str):
+    return [kind(x) for x in text.split(',') if x]
+
+
+def parse_omega(text):
+    if text != 'auto':
+        float(text)
+    return text
+
+
+def updates_per_iteration(factor):
+    # Entradas interiores de la grilla, sin las líneas de potencial.
+    return (10*factor - 2)*(10*factor - 1) - 12*factor
+
+
+def command(args, solver, variant, kernel, factor, omega, ranks, threads):
+    binary = os.path.join(args.bin, solver + '.out')
+    cmd = [binary] + VARIANTS[solver][variant]
+    cmd += ['--benchmark', '--factor', str(factor), '--tolerancia', str(args.tolerancia), '--omega', str(omega)]
+    if (solver, variant) in KERNEL_VARIANTS:
+        cmd += ['--kernel', kernel]
+    env = dict(os.environ, OMP_NUM_THREADS=str(threads))
+    if solver == 'mpi':
+        cmd = shlex.split(args.mpirun) + ['-np', str(ranks), '-x', 'OMP_NUM_THREADS'] + cmd
+    return cmd, env
+
+
+def run(cmd, env):
+    result = subprocess.run(cmd, env=env, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit('Error al ejecutar ' + ' '.join(cmd) + ':\n' + result.stderr)
+    times = re.findall(r'Ti[eé]mpo transcurrido: (\S+)', result.stdout)
+    iterations = re.findall(r'Iteraciones: (\d+)', result.stdout)
+    if not times or not iterations:
+        sys.exit('Salida no reconocida de ' + ' '.join(cmd) + ':\n' + result.stdout)
+    return float(times[-1]), int(iterations[-1])
+
+
+def parallelism(args, solver, variant):
+    # Pares (procesos, hilos) que se evalúan para cada variante.
+    if solver == 'serial':
+        return [(1, 1)]
+    if solver == 'openmp':
+        return [(1, t) for t in args.hilos]
+    if variant == 'hibrido':
+        return [(p, t) for p in args.procesos for t in args.hilos]
+    return [(p, 1) for p in args.procesos]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Banco de pruebas de los solucionadores del capacitor.')
+    parser.add_argument('--variantes', default='serial:gauss_seidel,openmp:wavefront,mpi:filas',
+                        help="lista de 'solucionador:variante' (por ejemplo 'openmp:simd,mpi:hibrido')")
+    parser.add_argument('--factores', default='20', help='factores de escala (para escalabilidad débil, factor con un trabajador)')
+    parser.add_argument('--hilos', default='1,2,4', help='cantidades de hilos de OpenMP')
+    parser.add_argument('--procesos', default='1,2,4', help='cantidades de procesos de MPI')
+    parser.add_argument('--omegas', default='0.9', help="parámetros de sobre-relajación ('auto' para el omega óptimo estimado)")
+    parser.add_argument('--kernels', default='auto', help='kernels de las variantes vectorizadas')
+    parser.add_argument('--tolerancia', type=float, default=1e-4)
+    parser.add_argument('--repeticiones', type=int, default=5)
+    parser.add_argument('--calentamiento', type=int, default=1, help='ejecuciones descartadas antes de medir')
+    parser.add_argument('--escalado', choices=['fuerte', 'debil', 'ambos'], default='fuerte')
+    parser.add_argument('--mpirun', default='mpirun --bind-to none', help='lanzador de MPI')
+    parser.add_argument('--bin', default=HERE, help='directorio de los ejecutables')
+    parser.add_argument('--salida', default=os.path.join(HERE, '..', '..', 'attachments'), help='directorio de los resultados')
+    args = parser.parse_args()
+
+    args.hilos = parse_list(args.hilos, int)
+    args.procesos = parse_list(args.procesos, int)
+    if args.repeticiones < 1:
+        sys.exit('La cantidad de repeticiones debe ser positiva!')
+
+    variants = []
+    for item in parse_list(args.variantes):
+        solver, _, variant = item.partition(':')
+        if solver not in VARIANTS or variant not in VARIANTS[solver]:
+            sys.exit('Variante no reconocida: ' + item)
+        variants.append((solver, variant))
+
+    modes = ['fuerte', 'debil'] if args.escalado == 'ambos' else [args.escalado]
+    rows = []
+    for mode in modes:
+        for solver, variant in variants:
+            kernels = parse_list(args.kernels) if (solver, variant) in KERNEL_VARIANTS else ['-']
+            for base in parse_list(args.factores, int):
+                for omega in parse_list(args.omegas, parse_omega):
+                    for kernel in kernels:
+                        for ranks, threads in parallelism(args, solver, variant):
+                            workers = ranks*threads
+                            factor = base if mode == 'fuerte' else max(1, round(base*math.sqrt(workers)))
+                            cmd, env = command(args, solver, variant, kernel, factor, omega, ranks, threads)
+                            for _ in range(args.calentamiento):
+                                run(cmd, env)
+                            times = []
+                            iterations = 0
+                            for _ in range(args.repeticiones):
+                                t, iterations = run(cmd, env)
+                                times.append(t)
+                            median = statistics.median(times)
+                            updates = iterations*updates_per_iteration(factor)
+                            bytes_per_update = BYTES_PER_UPDATE//2 if (solver, variant) in SINGLE_PRECISION_VARIANTS else BYTES_PER_UPDATE
+                            bytes_per_update /= TEMPORAL_DEPTH.get((solver, variant), 1)
+                            row = {'escalado': mode, 'solucionador': solver, 'variante': variant, 'kernel': kernel,
+                                   'factor_base': base, 'factor': factor, 'omega': omega, 'procesos': ranks, 'hilos': threads,
+                                   'trabajadores': workers, 'iteraciones': iterations, 't_mediana': median, 't_min': min(times),
+                                   'mactualizaciones_s': updates/median/1e6, 'ancho_banda_gbs': updates*bytes_per_update/median/1e9}
+                            rows.append(row)
+                            print('{escalado} {solucionador}:{variante} kernel={kernel} factor={factor} omega={omega} '
+                                  'procesos={procesos} hilos={hilos}: {iteraciones} iteraciones, mediana {t_mediana:.6g} s, '
+                                  'mínimo {t_min:.6g} s, {mactualizaciones_s:.4g} Mact/s, {ancho_banda_gbs:.4g} GB/s'.format(**row))
+
+    # Ahorro de iteraciones del omega automático respecto de cada omega fijo, con la misma configuración.
+    configurations = {}
+    for r in rows:
+        key = (r['escalado'], r['solucionador'], r['variante'], r['kernel'], r['factor'], r['procesos'], r['hilos'])
+        configurations.setdefault(key, {})[r['omega']] = r['iteraciones']
+    for (mode, solver, variant, kernel, factor, ranks, threads), iterations in configurations.items():
+        if 'auto' not in iterations:
+            continue
+        for omega, fixed in iterations.items():
+            if omega != 'auto':
+                print('Ahorro de iteraciones con omega automático en {}:{} factor={} procesos={} hilos={}: {} contra {} con omega {} ({:.1f}%)'.format(
+                    solver, variant, factor, ranks, threads, iterations['auto'], fixed, omega, 100.0*(fixed - iterations['auto'])/fixed))
+
+    os.makedirs(args.salida, exist_ok=True)
+    columns = ['escalado', 'solucionador', 'variante', 'kernel', 'factor_base', 'factor', 'omega', 'procesos', 'hilos', 'trabajadores',
+               'iteraciones', 't_mediana', 't_min', 'mactualizaciones_s', 'ancho_banda_gbs']
+    with open(os.path.join(args.salida, 'benchmark.dat'), 'w') as out:
+        out.write('# ' + ' '.join(columns) + '\n')
+        for row in rows:
+            out.write(' '.join(format(row[c], '.6g') if isinstance(row[c], float) else str(row[c]) for c in columns) + '\n')
+
+    # Un bloque por configuración (separados por dos líneas en blanco, para 'index' de gnuplot).
+    # La primera línea de cada bloque es el título que 'columnheader(1)' emplea en la leyenda.
+    for mode, name in (('fuerte', 'speedup.dat'), ('debil', 'weak.dat')):
+        selected = [r for r in rows if r['escalado'] == mode]
+        if not selected:
+            continue
+        groups = {}
+        for r in selected:
+            key = (r['solucionador'], r['variante'], r['kernel'], r['factor_base'], r['omega'])
+            groups.setdefault(key, []).append(r)
+        with open(os.path.join(args.salida, name), 'w') as out:
+            blocks = []
+            for (solver, variant, kernel, base, omega), group in groups.items():
+                group.sort(key=lambda r: (r['trabajadores'], r['procesos']))
+                reference = group[0]
+                title = '{} {}{} (factor {}, omega {})'.format(solver, variant, '' if kernel == '-' else ' ' + kernel, base, omega)
+                lines = ['"{}" speedup eficiencia t_mediana t_min procesos hilos'.format(title)]
+                for r in group:
+                    if mode == 'fuerte':
+                        speedup = reference['t_mediana']/r['t_mediana']
+                        efficiency = speedup*reference['trabajadores']/r['trabajadores']
+                    else:
+                        # Con entradas por trabajador constantes, el speedup escalado es P*t(1)/t(P). Se compara el tiempo por iteración, ya que la cantidad de iteraciones crece con el factor de escala.
+                        efficiency = (reference['t_mediana']/reference['iteraciones'])/(r['t_mediana']/r['iteraciones'])
+                        speedup = efficiency*r['trabajadores']/reference['trabajadores']
+                    lines.append('{} {:.5f} {:.5f} {:.6g} {:.6g} {} {}'.format(r['trabajadores'], speedup, efficiency, r['t_mediana'], r['t_min'],
+                                                                          r['procesos'], r['hilos']))
+                blocks.append('\n'.join(lines))
+            out.write('\n\n\n'.join(blocks) + '\n')
+
+
+if __name__ == '__main__':
+    main()
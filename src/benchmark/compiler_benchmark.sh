@@ -0,0 +1,11 @@
+#!/bin/bash
+
+# Compila los tres solucionadores y ejecuta el banco de pruebas. Los argumentos se pasan a 'benchmark.py', por ejemplo:
+#   ./compiler_benchmark.sh --variantes openmp:wavefront,openmp:simd --hilos 1,2,4,8 --factores 50
+#   ./compiler_benchmark.sh --variantes mpi:filas,mpi:hibrido --procesos 1,2,4 --hilos 1,2 --escalado ambos
+# Los resultados se escriben en 'attachments' ('benchmark.dat', 'speedup.dat' y 'weak.dat'); 'gnuplot fig.plt' genera las figuras.
+g++ -O2 -I../common ../serial_cpp/Capacitor.cpp -o serial.out
+g++ -O2 -fopenmp -I../common ../parallel_cpp/shared_memory/Capacitor_wavefront.cpp -o openmp.out
+mpicxx -O2 -fopenmp -I../common ../parallel_cpp/distributed_memory/Capacitor.cpp -o mpi.out
+
+python3 benchmark.py "$@"
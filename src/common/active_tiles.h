@@ -0,0 +1,169 @@
+#ifndef ACTIVE_TILES_H
+#define ACTIVE_TILES_H
+
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
+#include "stencil_kernel.h"
+
+// Modo incremental de las iteraciones rojo-negro de 'stencil_kernel.h': se barren únicamente los bloques de la grilla que aún cambian.
+// Lejos de las líneas de potencial la grilla converge antes que entre ellas, por lo que en las últimas iteraciones la mayor parte de un barrido completo actualiza entradas que ya no cambian.
+//   - El interior se divide en bloques bidimensionales de 'tileRows' filas por 'tileColumns' columnas (ver 'sweep_columns'), de forma que se omitan también las regiones a los lados y más allá de las placas,
+//     y se guarda la diferencia máxima de la última actualización de cada bloque.
+//   - Un bloque está activo si esa diferencia es mayor que 'threshold*tolerance'. En cada iteración se barren los bloques activos y sus cuatro vecinos, ya que un cambio se propaga a las entradas contiguas.
+//   - Cada 'verify_every' iteraciones, o cuando no quedan bloques activos, se realiza un barrido completo que reevalúa todos los bloques.
+//   - La convergencia se declara únicamente en un barrido completo, con el mismo criterio que el barrido simple, por lo que la tolerancia final está garantizada.
+// Dentro de una media iteración los bloques son independientes (cada color lee únicamente entradas del otro color), así que con OpenMP se reparten entre los hilos y el resultado no depende de la cantidad de hilos.
+
+struct ActiveTileSettings{
+  bool enabled = false;
+  // Filas por bloque; con cero se emplea ACTIVE_TILE_ROWS.
+  int tileRows = 0;
+  // Columnas por bloque, múltiplo de 16; con cero se emplea ACTIVE_TILE_COLUMNS.
+  int tileColumns = 0;
+  // Iteraciones entre barridos completos de verificación.
+  int verify_every = 10;
+  // Fracción de la tolerancia por debajo de la cual un bloque se considera convergido.
+  double threshold = 0.1;
+};
+
+const int ACTIVE_TILE_ROWS = 32;
+const int ACTIVE_TILE_COLUMNS = 128;
+
+// Ejecuciones de 'simd' y de 'simd_incremental' con '--comparar'. Ambos modos se miden igual y se reporta el menor tiempo de cada uno, con el mismo omega.
+const int ACTIVE_COMPARE_REPEATS = 3;
+
+struct ActiveTiles{
+  int rows = 0;
+  int columns = 0;
+  int tileRows = 0;
+  int tileColumns = 0;
+  // Bloques por columna y por fila de la grilla; el bloque 't' ocupa la fila de bloques t/columnTiles y la columna de bloques t%columnTiles.
+  int rowTiles = 0;
+  int columnTiles = 0;
+  int count = 0;
+  int verify_every = 0;
+  double threshold = 0.0;
+  // Diferencia máxima de la última actualización de cada bloque.
+  std::vector<double> delta;
+  // Bloques que se barren en la iteración actual.
+  std::vector<int> list;
+  bool full = true;
+  int lastFull = 0;
+  // Bloques barridos y bloques de un barrido simple con las mismas iteraciones.
+  long long swept = 0;
+  long long possible = 0;
+  // Bloques barridos en cada iteración.
+  std::vector<int> history;
+};
+
+inline void check_active_settings(const ActiveTileSettings& settings){
+  if(settings.tileRows < 0 || settings.tileColumns < 0 || settings.tileColumns % 16 != 0 || settings.verify_every < 1 || !(settings.threshold > 0 && settings.threshold <= 1)){
+    std::cerr << "El modo incremental requiere bloques de al menos una fila y de un múltiplo de 16 columnas, una frecuencia de verificación mayor que cero y un umbral en (0, 1]!" << std::endl;
+    exit(1);
+  }
+}
+
+// Bloques de una grilla rellena de 'rows' filas con ancho de fila 'stride' (las columnas que recorren los kernels).
+inline ActiveTiles active_tiles(int rows, int stride, const ActiveTileSettings& settings){
+  check_active_settings(settings);
+  ActiveTiles tiles;
+  tiles.rows = rows;
+  tiles.columns = stride;
+  tiles.tileRows = std::min(settings.tileRows > 0 ? settings.tileRows : ACTIVE_TILE_ROWS, std::max(1, rows-2));
+  tiles.tileColumns = std::min(settings.tileColumns > 0 ? settings.tileColumns : ACTIVE_TILE_COLUMNS, (stride + 15)/16*16);
+  tiles.rowTiles = (rows - 2 + tiles.tileRows-1)/tiles.tileRows;
+  tiles.columnTiles = (stride + tiles.tileColumns-1)/tiles.tileColumns;
+  tiles.count = tiles.rowTiles*tiles.columnTiles;
+  tiles.verify_every = settings.verify_every;
+  tiles.threshold = settings.threshold;
+  tiles.delta.assign(tiles.count, std::numeric_limits<double>::infinity());
+  return tiles;
+}
+
+// Filas [rowBegin, rowEnd) y columnas [colBegin, colEnd) del bloque 't'.
+inline void active_tile_range(const ActiveTiles& tiles, int t, int& rowBegin, int& rowEnd, int& colBegin, int& colEnd){
+  rowBegin = 1 + (t/tiles.columnTiles)*tiles.tileRows;
+  rowEnd = std::min(tiles.rows-1, rowBegin + tiles.tileRows);
+  colBegin = (t%tiles.columnTiles)*tiles.tileColumns;
+  colEnd = std::min(tiles.columns, colBegin + tiles.tileColumns);
+}
+
+// Escoge los bloques de la iteración 'its' (la que está por realizarse). Regresa verdadero si es un barrido completo.
+// Una iteración parcial con diferencia menor o igual a la tolerancia no fuerza la verificación: los bloques restantes se siguen barriendo hasta quedar bajo el umbral o hasta la siguiente verificación programada.
+inline bool schedule_tiles(ActiveTiles& tiles, int its, double tolerance){
+  double limit = tiles.threshold*tolerance;
+  tiles.list.clear();
+  tiles.full = its - tiles.lastFull >= tiles.verify_every;
+  if(!tiles.full){
+    for(int r=0; r < tiles.rowTiles; ++r){
+      for(int c=0; c < tiles.columnTiles; ++c){
+        int t = r*tiles.columnTiles + c;
+        bool active = tiles.delta[t] > limit
+          || (r > 0 && tiles.delta[t-tiles.columnTiles] > limit) || (r+1 < tiles.rowTiles && tiles.delta[t+tiles.columnTiles] > limit)
+          || (c > 0 && tiles.delta[t-1] > limit) || (c+1 < tiles.columnTiles && tiles.delta[t+1] > limit);
+        if(active){
+          tiles.list.push_back(t);
+        }
+      }
+    }
+    tiles.full = tiles.list.empty() || (int)tiles.list.size() == tiles.count;
+  }
+  if(tiles.full){
+    tiles.list.resize(tiles.count);
+    for(int t=0; t < tiles.count; ++t){
+      tiles.list[t] = t;
+    }
+    tiles.lastFull = its;
+  }
+  tiles.swept += tiles.list.size();
+  tiles.possible += tiles.count;
+  tiles.history.push_back(tiles.list.size());
+  return tiles.full;
+}
+
+// Media iteración roja y negra sobre los bloques escogidos. Regresa la diferencia máxima de la iteración, que sólo permite evaluar la convergencia si 'tiles.full'.
+// Debe llamarse fuera de una región paralela; sin OpenMP los bloques se recorren en orden.
+template<typename Real>
+inline Real active_sweeps(const BasicStencilKernel<Real>& stencil, Real* phi, const unsigned char* mask, int stride, ActiveTiles& tiles, Real omega){
+  int n = tiles.list.size();
+  Real maxDelta = 0;
+  #pragma omp parallel
+  for(int color=0; color < 2; ++color){
+    #pragma omp for schedule(static) reduction(max:maxDelta)
+    for(int k=0; k < n; ++k){
+      int t = tiles.list[k];
+      int rowBegin, rowEnd, colBegin, colEnd;
+      active_tile_range(tiles, t, rowBegin, rowEnd, colBegin, colEnd);
+      Real delta = stencil.sweep_columns(phi, mask, stride, rowBegin, rowEnd, colBegin, colEnd, 0, color, omega);
+      tiles.delta[t] = (color == 0) ? (double)delta : std::max(tiles.delta[t], (double)delta);
+      maxDelta = std::max(maxDelta, delta);
+    }
+  }
+  return maxDelta;
+}
+
+// Fracción de los bloques de un barrido simple con las mismas iteraciones que no se barrieron.
+inline double skipped_fraction(const ActiveTiles& tiles){
+  return (double)(tiles.possible - tiles.swept)/std::max(1LL, tiles.possible);
+}
+
+// Reporte del modo incremental: bloques barridos a lo largo de las iteraciones (una muestra de a lo sumo 'samples' iteraciones) y fracción de bloques omitidos.
+inline void report_active_tiles(const ActiveTiles& tiles, int samples = 10){
+  std::cout << "Modo incremental: " << tiles.count << " bloques de " << tiles.tileRows << "x" << tiles.tileColumns << " entradas; verificación cada " << tiles.verify_every << " iteraciones" << std::endl;
+  std::cout << "Bloques barridos (iteración: bloques):";
+  int n = tiles.history.size();
+  int step = std::max(1, (n + samples-1)/samples);
+  for(int k=0; k < n; k += step){
+    std::cout << " " << k+1 << ": " << tiles.history[k];
+  }
+  if(n > 0 && (n-1) % step != 0){
+    std::cout << " " << n << ": " << tiles.history[n-1];
+  }
+  std::cout << std::endl;
+  std::cout << "Bloques omitidos: " << 100.0*skipped_fraction(tiles) << "% de " << tiles.possible << std::endl;
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <sys/time.h>
+#include "grid2d.h"
+#include "temporal_blocking.h"
+#include "telemetry.h"
+
+// Micro-benchmark de los kernels de 'stencil_kernel.h'.
+// Se mide la cantidad de entradas actualizadas por segundo de un número fijo de iteraciones rojo-negro, comparando el recorrido con la condición de las líneas de potencial (como en 'gauss_seidel_redblack') contra cada uno de los kernels disponibles.
+// Luego se compara el barrido simple del kernel automático contra el bloqueo temporal de 'temporal_blocking.h' con varias profundidades, reportando el tráfico estimado hacia memoria por actualización:
+// el barrido simple lee y escribe la grilla en cada media iteración (4 pasadas por iteración) y el bloqueo temporal una vez cada 'depth' iteraciones (2/depth pasadas).
+// Si se compila con '-DCAPACITOR_TELEMETRY' se mide además la reducción de fallos de la caché de último nivel con los contadores de hardware de 'telemetry.h'.
+// La reducción de tráfico sólo se refleja en el tiempo si la grilla no cabe en la caché de último nivel (por ejemplo, factor 300: unos 70 MB).
+// Uso: './a.out [factor] [iteraciones]'.
+
+// Función que regresa la medición del tiempo actual.
+double seconds(){
+  struct timeval tmp;
+  double sec;
+  gettimeofday( &tmp, (struct timezone *)0 );
+  sec = tmp.tv_sec + ((double)tmp.tv_usec)/1000000.0;
+
+  return sec;
+}
+
+// Iteraciones rojo-negro con la condición de las líneas de potencial dentro del ciclo interno, sobre la grilla sin relleno.
+double branch_sweeps(GridVector& phi, double omega, int factor, int sweeps){
+  int column = 10*factor+1;
+  double maxDelta = 0.0;
+  for(int s=0; s < sweeps; ++s){
+    for(int color=0; color < 2; ++color){
+      for(int i=1; i < 10*factor-1; ++i){
+        for(int j=1 + (i+1+color)%2; j < column-1; j += 2){
+          if((2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor)){
+            continue;
+          }
+          double new_value = ((1.0+omega)*0.25)*(phi[(i+1)*column + j] + phi[(i-1)*column + j] + phi[i*column + (j+1)] + phi[i*column + (j-1)]) - omega*phi[i*column + j];
+          maxDelta = std::max(maxDelta, std::abs(new_value - phi[i*column + j]));
+          phi[i*column + j] = new_value;
+        }
+      }
+    }
+  }
+  return maxDelta;
+}
+
+int main(int argc, char* argv[]){
+  int factor = 50;
+  int sweeps = 200;
+  double omega = 0.9;
+  if(argc > 1){
+    factor = std::stoi(argv[1]);
+  }
+  if(argc > 2){
+    sweeps = std::stoi(argv[2]);
+  }
+
+  int rows = 10*factor;
+  int column = 10*factor+1;
+  // Entradas actualizadas por iteración: el interior de la grilla sin las líneas de potencial.
+  double updates = (double)(rows-2)*(column-2) - 2.0*6*factor;
+
+  GridVector grid = grid_generator(factor, 1.0, -1.0);
+  double time_1 = seconds();
+  branch_sweeps(grid, omega, factor, sweeps);
+  double time_2 = seconds();
+  double baseline = updates*sweeps/(time_2 - time_1);
+  std::cout << "Kernel: condicional; Tiempo transcurrido: " << time_2 - time_1 << "; Millones de actualizaciones por segundo: " << baseline/1e6 << "; Aceleración: 1" << std::endl;
+
+  std::vector<std::string> kernels = {"scalar"};
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2")){
+    kernels.push_back("avx2");
+  }
+  if(__builtin_cpu_supports("avx512f")){
+    kernels.push_back("avx512");
+  }
+
+  int stride = grid_stride(column);
+  std::vector<unsigned char> mask = capacitor_mask(rows, column, stride, factor);
+  for(const std::string& name : kernels){
+    StencilKernel stencil = select_kernel(name);
+    Grid2D<double> padded(rows, column);
+    padded.load(grid_generator(factor, 1.0, -1.0));
+    time_1 = seconds();
+    for(int s=0; s < sweeps; ++s){
+      stencil.sweep(padded.data(), mask.data(), stride, 1, rows-1, 0, 0, omega);
+      stencil.sweep(padded.data(), mask.data(), stride, 1, rows-1, 0, 1, omega);
+    }
+    time_2 = seconds();
+    double rate = updates*sweeps/(time_2 - time_1);
+    std::cout << "Kernel: " << stencil.name << "; Tiempo transcurrido: " << time_2 - time_1 << "; Millones de actualizaciones por segundo: " << rate/1e6 << "; Aceleración: " << rate/baseline << std::endl;
+  }
+
+  // Bloqueo temporal. Profundidad 1 corresponde al barrido simple; el número de iteraciones se redondea a un múltiplo de la profundidad.
+  StencilKernel stencil = select_kernel("auto");
+  double grid_bytes = (double)rows*stride*sizeof(double);
+  double plain_rate = 0.0;
+  double plain_misses = -1.0;
+#ifdef CAPACITOR_TELEMETRY
+  telemetry_open("", true);
+#endif
+  for(int depth : {1, 2, 4, 8}){
+    int blockRows = temporal_block_rows<double>(stride, depth);
+    int blocked_sweeps = std::max(depth, sweeps - sweeps % depth);
+    Grid2D<double> padded(rows, column);
+    padded.load(grid_generator(factor, 1.0, -1.0));
+    double misses = -1.0;
+#ifdef CAPACITOR_TELEMETRY
+    long long before[TELEMETRY_COUNTERS];
+    bool counted = read_counters(telemetry(), before);
+#endif
+    time_1 = seconds();
+    for(int s=0; s < blocked_sweeps; s += depth){
+      if(depth > 1){
+        temporal_sweeps(stencil, padded.data(), mask.data(), stride, rows, depth, blockRows, omega);
+      } else{
+        stencil.sweep(padded.data(), mask.data(), stride, 1, rows-1, 0, 0, omega);
+        stencil.sweep(padded.data(), mask.data(), stride, 1, rows-1, 0, 1, omega);
+      }
+    }
+    time_2 = seconds();
+#ifdef CAPACITOR_TELEMETRY
+    long long after[TELEMETRY_COUNTERS];
+    if(counted && read_counters(telemetry(), after)){
+      misses = (double)(after[2] - before[2])/(updates*blocked_sweeps);
+    }
+#endif
+    double rate = updates*blocked_sweeps/(time_2 - time_1);
+    double traffic = ((depth > 1) ? 2.0/depth : 4.0)*grid_bytes/updates;
+    if(depth == 1){
+      plain_rate = rate;
+      plain_misses = misses;
+    }
+    std::cout << "Bloque temporal: " << depth;
+    if(depth > 1){
+      std::cout << " (" << blockRows << " filas)";
+    }
+    std::cout << "; Kernel: " << stencil.name << "; Tiempo transcurrido: " << time_2 - time_1 << "; Millones de actualizaciones por segundo: " << rate/1e6
+              << "; Aceleración: " << rate/plain_rate << "; Tráfico estimado por actualización (bytes): " << traffic << "; Reducción de tráfico estimada: " << 4.0*grid_bytes/updates/traffic;
+    if(misses >= 0.0){
+      std::cout << "; Fallos de caché por actualización: " << misses;
+      if(plain_misses > 0.0){
+        std::cout << "; Reducción de fallos de caché: " << plain_misses/misses;
+      }
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
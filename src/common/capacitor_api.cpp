@@ -0,0 +1,252 @@
+#include <vector>
+#include <string>
+#include <memory>
+#include <new>
+#include <cmath>
+#include <algorithm>
+#include <sys/time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "capacitor_api.h"
+#include "grid2d.h"
+#include "stencil_kernel.h"
+#include "omega_tuning.h"
+
+// Biblioteca compartida con la interfaz de 'capacitor_api.h' (compilar con CMake, objetivo 'capacitor', o con 'src/serial_py/compiler.sh').
+// El solucionador es el método 'simd' de memoria compartida: iteraciones rojo-negro con sobre-relajación y el kernel vectorizado de 'stencil_kernel.h',
+// con el bloque de filas de cada hilo de 'thread_rows'. Se ejecuta sobre la grilla rellena de quien llama (o sobre un 'Grid2D' propio), sin copiarla.
+
+struct CapacitorSolver{
+  int factor;
+  int rows;
+  int columns;
+  int stride;
+  BasicStencilKernel<double> stencil;
+  std::vector<unsigned char> mask;
+  // Grilla propia cuando quien llama no proporciona memoria.
+  std::unique_ptr<Grid2D<double>> owned;
+  double* phi;
+  int iterations;
+  double delta;
+  double omega;
+  double elapsed;
+  int threads;
+};
+
+static double seconds(){
+  struct timeval tmp;
+  gettimeofday(&tmp, (struct timezone *)0);
+  return tmp.tv_sec + ((double)tmp.tv_usec)/1000000.0;
+}
+
+// Valida el nombre del kernel y el soporte del procesador antes de 'select_kernel', que termina el proceso ante un error.
+static bool kernel_available(const std::string& name){
+  __builtin_cpu_init();
+  if(name == "avx512"){
+    return __builtin_cpu_supports("avx512f");
+  }
+  if(name == "avx2"){
+    return __builtin_cpu_supports("avx2");
+  }
+  return name == "auto" || name == "scalar";
+}
+
+extern "C" {
+
+int capacitor_api_version(void){
+  return CAPACITOR_API_VERSION;
+}
+
+int capacitor_rows(int factor){
+  return (factor < 1) ? 0 : 10*factor;
+}
+
+int capacitor_columns(int factor){
+  return (factor < 1) ? 0 : 10*factor+1;
+}
+
+int capacitor_stride(int factor){
+  return (factor < 1) ? 0 : grid_stride<double>(10*factor+1);
+}
+
+size_t capacitor_buffer_size(int factor){
+  return (size_t)capacitor_rows(factor)*capacitor_stride(factor);
+}
+
+CapacitorSolver* capacitor_create(int factor, double V1, double V2, double* buffer, const char* kernel, int* status){
+  int code = CAPACITOR_OK;
+  CapacitorSolver* solver = nullptr;
+  std::string name = (kernel == nullptr) ? "auto" : kernel;
+  if(factor < 1){
+    code = CAPACITOR_ERROR_ARGUMENT;
+  } else if(!kernel_available(name)){
+    code = CAPACITOR_ERROR_KERNEL;
+  } else{
+    try{
+      solver = new CapacitorSolver();
+      solver->factor = factor;
+      solver->rows = capacitor_rows(factor);
+      solver->columns = capacitor_columns(factor);
+      solver->stride = capacitor_stride(factor);
+      solver->stencil = select_kernel<double>(name);
+      solver->mask = capacitor_mask(solver->rows, solver->columns, solver->stride, factor);
+      if(buffer == nullptr){
+        solver->owned.reset(new Grid2D<double>(solver->rows, solver->columns));
+        solver->phi = solver->owned->data();
+      } else{
+        // La memoria de quien llama se escribe por primera vez con la misma división de filas de los barridos (ver 'grid2d.h').
+        solver->phi = buffer;
+        int rows = solver->rows;
+        int stride = solver->stride;
+        #pragma omp parallel
+        {
+        int thread = 0;
+        int threads = 1;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+        threads = omp_get_num_threads();
+#endif
+        int begin, end;
+        thread_rows(rows, thread, threads, begin, end);
+        if(thread == 0){
+          begin = 0;
+        }
+        if(thread == threads-1){
+          end = rows;
+        }
+        std::fill(buffer + (size_t)begin*stride, buffer + (size_t)end*stride, 0.0);
+        }
+      }
+      for(int i=2*factor; i < 8*factor; ++i){
+        solver->phi[(size_t)i*solver->stride + 2*factor] = V1;
+        solver->phi[(size_t)i*solver->stride + 8*factor] = V2;
+      }
+      solver->iterations = 0;
+      solver->delta = 0.0;
+      solver->omega = 0.0;
+      solver->elapsed = 0.0;
+      solver->threads = 1;
+    } catch(const std::bad_alloc&){
+      delete solver;
+      solver = nullptr;
+      code = CAPACITOR_ERROR_MEMORY;
+    }
+  }
+  if(status != nullptr){
+    *status = code;
+  }
+  return solver;
+}
+
+int capacitor_solve(CapacitorSolver* solver, double omega, double tolerance, int check_every, int max_iterations){
+  if(solver == nullptr || !(tolerance > 0) || check_every < 1 || max_iterations < 0){
+    return CAPACITOR_ERROR_ARGUMENT;
+  }
+  if(omega == CAPACITOR_AUTO_OMEGA){
+    int steps;
+    omega = optimal_omega(jacobi_spectral_radius(solver->factor, steps));
+  }
+  const BasicStencilKernel<double>& stencil = solver->stencil;
+  double* phi = solver->phi;
+  const unsigned char* mask = solver->mask.data();
+  int rows = solver->rows;
+  int stride = solver->stride;
+
+  double delta = 1.0;
+  double maxDelta = 0.0;
+  int its = 0;
+  int status = CAPACITOR_OK;
+  double time_1 = seconds();
+  while(delta > tolerance){
+    if(max_iterations > 0 && its >= max_iterations){
+      status = CAPACITOR_NOT_CONVERGED;
+      break;
+    }
+    maxDelta = 0.0;
+    #pragma omp parallel reduction(max:maxDelta)
+    {
+    // Bloque de filas interiores [rowBegin, rowEnd) del hilo.
+    int rowBegin = 1;
+    int rowEnd = rows-1;
+#ifdef _OPENMP
+    thread_rows(rows, omp_get_thread_num(), omp_get_num_threads(), rowBegin, rowEnd);
+#endif
+    maxDelta = stencil.sweep(phi, mask, stride, rowBegin, rowEnd, 0, 0, omega);
+    #pragma omp barrier
+    maxDelta = std::max(maxDelta, stencil.sweep(phi, mask, stride, rowBegin, rowEnd, 0, 1, omega));
+    }
+    its++;
+    if(its % check_every == 0){
+      delta = maxDelta;
+    }
+    if(!(maxDelta <= 1e10)){
+      status = CAPACITOR_ERROR_DIVERGENCE;
+      break;
+    }
+  }
+  solver->elapsed = seconds() - time_1;
+  solver->iterations = its;
+  solver->delta = maxDelta;
+  solver->omega = omega;
+#ifdef _OPENMP
+  solver->threads = omp_get_max_threads();
+#endif
+  return status;
+}
+
+double* capacitor_data(CapacitorSolver* solver){
+  return (solver == nullptr) ? nullptr : solver->phi;
+}
+
+int capacitor_factor(const CapacitorSolver* solver){
+  return (solver == nullptr) ? 0 : solver->factor;
+}
+
+int capacitor_iterations(const CapacitorSolver* solver){
+  return (solver == nullptr) ? 0 : solver->iterations;
+}
+
+double capacitor_delta(const CapacitorSolver* solver){
+  return (solver == nullptr) ? NAN : solver->delta;
+}
+
+double capacitor_omega(const CapacitorSolver* solver){
+  return (solver == nullptr) ? NAN : solver->omega;
+}
+
+double capacitor_elapsed(const CapacitorSolver* solver){
+  return (solver == nullptr) ? NAN : solver->elapsed;
+}
+
+int capacitor_threads(const CapacitorSolver* solver){
+  return (solver == nullptr) ? 0 : solver->threads;
+}
+
+const char* capacitor_kernel(const CapacitorSolver* solver){
+  return (solver == nullptr) ? "" : solver->stencil.name.c_str();
+}
+
+void capacitor_destroy(CapacitorSolver* solver){
+  delete solver;
+}
+
+const char* capacitor_error(int status){
+  switch(status){
+    case CAPACITOR_OK:
+      return "Sin error";
+    case CAPACITOR_NOT_CONVERGED:
+      return "Se alcanzó el máximo de iteraciones sin llegar a la tolerancia";
+    case CAPACITOR_ERROR_ARGUMENT:
+      return "Argumento no válido: el factor de escala, la tolerancia y la frecuencia de evaluación deben ser positivos";
+    case CAPACITOR_ERROR_KERNEL:
+      return "Kernel no reconocido o no soportado por el procesador. Las opciones son 'auto', 'avx512', 'avx2' y 'scalar'";
+    case CAPACITOR_ERROR_MEMORY:
+      return "No se pudo reservar la memoria de la grilla";
+    case CAPACITOR_ERROR_DIVERGENCE:
+      return "La diferencia crece sin control; se debe reducir omega";
+  }
+  return "Código de error desconocido";
+}
+
+}
@@ -0,0 +1,76 @@
+#ifndef CAPACITOR_API_H
+#define CAPACITOR_API_H
+
+#include <stddef.h>
+
+// Interfaz en C de la biblioteca compartida 'libcapacitor' (ver 'capacitor_api.cpp'), para emplear el solucionador rojo-negro vectorizado desde otros lenguajes sin pasar por archivos.
+// La grilla es un arreglo relleno de capacitor_rows(factor) filas con capacitor_stride(factor) dobles por fila, de las cuales las primeras capacitor_columns(factor) son la grilla de 'grid_generator':
+//   - La memoria puede pertenecer a quien llama ('buffer' no nulo en 'capacitor_create', de capacitor_buffer_size(factor) dobles, de preferencia alineado a 64 bytes), o a la biblioteca ('buffer' nulo),
+//     en cuyo caso 'capacitor_data' la expone. En ambos casos el solucionador trabaja directamente sobre esa memoria, sin copias.
+//   - Entre llamadas se puede modificar la grilla (por ejemplo, para fijar un valor inicial); las líneas de potencial y los bordes no se actualizan.
+// Las funciones no terminan el proceso: los errores se reportan con los códigos CAPACITOR_ERROR_* y 'capacitor_error' regresa su descripción.
+// La interfaz es estable: sólo se agregan funciones y CAPACITOR_API_VERSION aumenta cuando eso ocurre.
+
+#define CAPACITOR_API_VERSION 1
+
+#if defined(__GNUC__)
+#define CAPACITOR_EXPORT __attribute__((visibility("default")))
+#else
+#define CAPACITOR_EXPORT
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Códigos de regreso. CAPACITOR_NOT_CONVERGED indica que se alcanzó el máximo de iteraciones sin llegar a la tolerancia; la grilla contiene la última iteración.
+enum{
+  CAPACITOR_OK = 0,
+  CAPACITOR_NOT_CONVERGED = 1,
+  CAPACITOR_ERROR_ARGUMENT = -1,
+  CAPACITOR_ERROR_KERNEL = -2,
+  CAPACITOR_ERROR_MEMORY = -3,
+  CAPACITOR_ERROR_DIVERGENCE = -4
+};
+
+// Valor de 'omega' para escogerlo automáticamente a partir del radio espectral de Jacobi (ver 'omega_tuning.h').
+#define CAPACITOR_AUTO_OMEGA (-1.0)
+
+typedef struct CapacitorSolver CapacitorSolver;
+
+CAPACITOR_EXPORT int capacitor_api_version(void);
+
+// Dimensiones de la grilla para el factor de escala dado (0 si el factor no es válido).
+CAPACITOR_EXPORT int capacitor_rows(int factor);
+CAPACITOR_EXPORT int capacitor_columns(int factor);
+CAPACITOR_EXPORT int capacitor_stride(int factor);
+CAPACITOR_EXPORT size_t capacitor_buffer_size(int factor);
+
+// Crea un solucionador e inicializa la grilla (ceros con las líneas de potencial V1 y V2). 'kernel' es 'auto', 'avx512', 'avx2' o 'scalar' ('auto' si es nulo).
+// Regresa NULL en caso de error, con el código en 'status' si no es nulo.
+CAPACITOR_EXPORT CapacitorSolver* capacitor_create(int factor, double V1, double V2, double* buffer, const char* kernel, int* status);
+
+// Itera hasta que la diferencia máxima de una iteración sea menor o igual a 'tolerance', evaluándola cada 'check_every' iteraciones. 'max_iterations' nulo no limita las iteraciones.
+// Con OpenMP se emplean 'omp_get_max_threads()' hilos. Regresa CAPACITOR_OK, CAPACITOR_NOT_CONVERGED o un código de error.
+CAPACITOR_EXPORT int capacitor_solve(CapacitorSolver* solver, double omega, double tolerance, int check_every, int max_iterations);
+
+// Consultas sobre el solucionador y la última llamada a 'capacitor_solve'.
+CAPACITOR_EXPORT double* capacitor_data(CapacitorSolver* solver);
+CAPACITOR_EXPORT int capacitor_factor(const CapacitorSolver* solver);
+CAPACITOR_EXPORT int capacitor_iterations(const CapacitorSolver* solver);
+CAPACITOR_EXPORT double capacitor_delta(const CapacitorSolver* solver);
+CAPACITOR_EXPORT double capacitor_omega(const CapacitorSolver* solver);
+CAPACITOR_EXPORT double capacitor_elapsed(const CapacitorSolver* solver);
+CAPACITOR_EXPORT int capacitor_threads(const CapacitorSolver* solver);
+CAPACITOR_EXPORT const char* capacitor_kernel(const CapacitorSolver* solver);
+
+// Libera el solucionador; la memoria de quien llama no se modifica.
+CAPACITOR_EXPORT void capacitor_destroy(CapacitorSolver* solver);
+
+CAPACITOR_EXPORT const char* capacitor_error(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
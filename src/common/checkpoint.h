@@ -0,0 +1,195 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+// Archivos binarios de la grilla, empleados como puntos de control, para reanudar una ejecución y como valor inicial interpolado desde otro factor de escala.
+// El formato es el de la salida binaria de la versión distribuida ('write_binary'): un encabezado de 64 bytes seguido de la grilla como dobles little-endian por filas, por lo que el archivo se puede mapear en memoria directamente ('np.memmap' con 'offset=64').
+//   bytes 0-7:   identificador "CAPGRID1"
+//   bytes 8-23:  filas, columnas, factor de escala e iteraciones (enteros de 32 bits)
+//   bytes 24-47: V1, V2 y omega (dobles)
+//   bytes 48-55: tolerancia con la que se obtuvo la grilla (doble; cero si no se conoce)
+//   bytes 56-63: reservados (ceros)
+
+const int GRID_HEADER_BYTES = 64;
+
+struct GridHeader{
+  int rows = 0;
+  int columns = 0;
+  int factor = 0;
+  int iterations = 0;
+  double V1 = 0.0;
+  double V2 = 0.0;
+  double omega = 0.0;
+  double tolerance = 0.0;
+};
+
+inline void encode_header(const GridHeader& header, char* bytes){
+  std::memset(bytes, 0, GRID_HEADER_BYTES);
+  int dims[4] = {header.rows, header.columns, header.factor, header.iterations};
+  double values[4] = {header.V1, header.V2, header.omega, header.tolerance};
+  std::memcpy(bytes, "CAPGRID1", 8);
+  std::memcpy(bytes + 8, dims, sizeof(dims));
+  std::memcpy(bytes + 24, values, sizeof(values));
+}
+
+// Regresa falso si los bytes no corresponden a un encabezado válido.
+inline bool decode_header(const char* bytes, GridHeader& header){
+  if(std::memcmp(bytes, "CAPGRID1", 8) != 0){
+    return false;
+  }
+  int dims[4];
+  double values[4];
+  std::memcpy(dims, bytes + 8, sizeof(dims));
+  std::memcpy(values, bytes + 24, sizeof(values));
+  header.rows = dims[0];
+  header.columns = dims[1];
+  header.factor = dims[2];
+  header.iterations = dims[3];
+  header.V1 = values[0];
+  header.V2 = values[1];
+  header.omega = values[2];
+  header.tolerance = values[3];
+  return header.rows == 10*header.factor && header.columns == 10*header.factor+1;
+}
+
+// Lectura de un archivo completo. Regresa falso si el archivo no existe; un archivo con otro formato termina la ejecución.
+template<typename Allocator>
+inline bool read_grid_file(const std::string& path, GridHeader& header, std::vector<double, Allocator>& data){
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if(file == NULL){
+    return false;
+  }
+  char bytes[GRID_HEADER_BYTES];
+  if(std::fread(bytes, 1, GRID_HEADER_BYTES, file) != (size_t)GRID_HEADER_BYTES || !decode_header(bytes, header)){
+    std::cerr << "El archivo " << path << " no tiene el formato binario de la grilla!" << std::endl;
+    exit(1);
+  }
+  data.resize((size_t)header.rows*header.columns);
+  if(std::fread(data.data(), sizeof(double), data.size(), file) != data.size()){
+    std::cerr << "El archivo " << path << " está incompleto!" << std::endl;
+    exit(1);
+  }
+  std::fclose(file);
+  return true;
+}
+
+// Escritura de un archivo completo. Se escribe primero 'path.tmp' y luego se renombra, de forma que una ejecución interrumpida nunca deja un punto de control incompleto.
+template<typename Allocator>
+inline void write_grid_file(const std::string& path, const GridHeader& header, const std::vector<double, Allocator>& data){
+  if(__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__){
+    std::cerr << "La salida binaria sólo está disponible en arquitecturas little-endian!" << std::endl;
+    exit(1);
+  }
+  std::string temporary = path + ".tmp";
+  std::FILE* file = std::fopen(temporary.c_str(), "wb");
+  if(file == NULL){
+    std::cerr << "No se pudo abrir el archivo de salida: " << temporary << std::endl;
+    exit(1);
+  }
+  char bytes[GRID_HEADER_BYTES];
+  encode_header(header, bytes);
+  std::fwrite(bytes, 1, GRID_HEADER_BYTES, file);
+  std::fwrite(data.data(), sizeof(double), data.size(), file);
+  if(std::fclose(file) != 0 || std::rename(temporary.c_str(), path.c_str()) != 0){
+    std::cerr << "Error al escribir el archivo de salida: " << path << std::endl;
+    exit(1);
+  }
+}
+
+// Interpolación bilineal de las filas [rowBegin, rowEnd) de la grilla del factor 'factor' a partir de la grilla 'data' de otro factor de escala.
+// Ambas grillas cubren la misma región (la entrada (i,j) del factor f se ubica en (i/f, j/f)), por lo que las líneas de potencial coinciden; los bordes y las líneas de potencial se imponen nuevamente con V1 y V2.
+inline std::vector<double> interpolate_rows(const GridHeader& source, const std::vector<double>& data, int factor, int rowBegin, int rowEnd, double V1, double V2){
+  int column = 10*factor+1;
+  double scale = (double)source.factor/factor;
+  std::vector<double> rows((size_t)(rowEnd-rowBegin)*column, 0.0);
+  for(int i=rowBegin; i < rowEnd; ++i){
+    double x = std::min(i*scale, source.rows-1.0);
+    int I = std::min((int)x, source.rows-2);
+    double wx = x - I;
+    for(int j=0; j < column; ++j){
+      double y = std::min(j*scale, source.columns-1.0);
+      int J = std::min((int)y, source.columns-2);
+      double wy = y - J;
+      double value = (1-wx)*((1-wy)*data[(size_t)I*source.columns + J] + wy*data[(size_t)I*source.columns + J+1])
+                   + wx*((1-wy)*data[(size_t)(I+1)*source.columns + J] + wy*data[(size_t)(I+1)*source.columns + J+1]);
+      bool border = (i == 0 || j == 0 || i == 10*factor-1 || j == column-1);
+      bool plate = (2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor);
+      if(border){
+        value = 0.0;
+      } else if(plate){
+        value = (j == 2*factor) ? V1 : V2;
+      }
+      rows[(size_t)(i-rowBegin)*column + j] = value;
+    }
+  }
+  return rows;
+}
+
+// Configuración de los puntos de control de un solucionador.
+struct CheckpointSettings{
+  // Archivo del punto de control; vacío para no escribirlos.
+  std::string path = "";
+  // Cada cuántas iteraciones se escribe el punto de control. También se escribe al finalizar.
+  int every = 100;
+  // Reanudar desde 'path' si el archivo existe.
+  bool resume = false;
+  // Solución de otro factor de escala que se interpola como valor inicial.
+  std::string initial = "";
+  // Iteraciones realizadas antes de reanudar (ver 'load_initial_state').
+  int start = 0;
+};
+
+// Valor inicial de la grilla completa 'phi' (generada por 'grid_generator'): el punto de control si se reanuda y existe, o la interpolación de 'initial'.
+// Regresa las iteraciones previas, que también se guardan en 'settings.start'.
+template<typename Allocator>
+inline int load_initial_state(CheckpointSettings& settings, std::vector<double, Allocator>& phi, int factor, double V1, double V2){
+  GridHeader header;
+  std::vector<double> data;
+  settings.start = 0;
+  if(settings.resume && !settings.path.empty() && read_grid_file(settings.path, header, data)){
+    if(header.factor != factor){
+      std::cerr << "El punto de control " << settings.path << " corresponde al factor " << header.factor << " y no al factor " << factor << "!" << std::endl;
+      exit(1);
+    }
+    phi.assign(data.begin(), data.end());
+    settings.start = header.iterations;
+    std::cerr << "Reanudando desde " << settings.path << " con " << header.iterations << " iteraciones previas" << std::endl;
+  } else if(!settings.initial.empty()){
+    if(!read_grid_file(settings.initial, header, data)){
+      std::cerr << "No se pudo abrir el archivo inicial: " << settings.initial << std::endl;
+      exit(1);
+    }
+    std::vector<double> rows = interpolate_rows(header, data, factor, 0, 10*factor, V1, V2);
+    phi.assign(rows.begin(), rows.end());
+    std::cerr << "Valor inicial interpolado desde " << settings.initial << " (factor " << header.factor << ")" << std::endl;
+  }
+  return settings.start;
+}
+
+// Escribe el punto de control de la grilla completa después de la iteración 'its' (el total, incluyendo las previas a la reanudación).
+// Con 'final' se escribe sin importar el intervalo. V1 y V2 se leen de las líneas de potencial de la grilla.
+template<typename Allocator>
+inline void save_checkpoint(const CheckpointSettings& settings, const std::vector<double, Allocator>& phi, int factor, double omega, int its, bool final = false){
+  if(settings.path.empty() || (!final && its % settings.every != 0)){
+    return;
+  }
+  int column = 10*factor+1;
+  GridHeader header;
+  header.rows = 10*factor;
+  header.columns = column;
+  header.factor = factor;
+  header.iterations = its;
+  header.V1 = phi[(size_t)2*factor*column + 2*factor];
+  header.V2 = phi[(size_t)2*factor*column + 8*factor];
+  header.omega = omega;
+  write_grid_file(settings.path, header, phi);
+}
+
+#endif
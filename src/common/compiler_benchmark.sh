@@ -0,0 +1,5 @@
+#!/bin/bash
+
+# Micro-benchmark de los kernels vectorizados. Argumentos opcionales: factor de escala e iteraciones.
+g++ -O2 benchmark_kernel.cpp
+./a.out "$@"
@@ -0,0 +1,250 @@
+#ifndef GRID2D_H
+#define GRID2D_H
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <sys/mman.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "stencil_kernel.h"
+
+// Grillas del capacitor compartidas por los solucionadores.
+// 'grid_generator' produce la grilla contigua (sin relleno) de (10*factor)x(10*factor+1) que emplean los recorridos lexicográficos, multigrid y la salida.
+// 'Grid2D' es la grilla rellena de los kernels vectorizados de 'stencil_kernel.h':
+//   - Cada fila inicia en un múltiplo de 64 bytes (una línea de caché); el ancho de fila se redondea con 'padded_stride'.
+//   - Si el ancho de fila en bytes es múltiplo de 2048 se agrega una línea de caché de relleno, ya que de lo contrario las filas vecinas del stencil compiten por los mismos conjuntos de la caché L1.
+//   - Opcionalmente la memoria se reserva con páginas grandes ('mmap' y 'madvise(MADV_HUGEPAGE)'), lo que reduce los fallos de TLB en grillas grandes.
+//   - La memoria se reserva sin inicializar y se escribe por primera vez en paralelo, con la misma división de filas que emplean los hilos en los barridos ('thread_rows').
+//     En nodos con varios sockets (NUMA) cada página queda así en la memoria local del hilo que la recorre.
+// La grilla contigua de 'grid_generator' (y los vectores de trabajo de 'pcg') también se escriben por primera vez en paralelo, con su asignador ('FirstTouchAllocator'):
+//   - 'redblack', 'pcg' y los niveles de 'multigrid' de memoria compartida reparten filas contiguas entre los hilos, por lo que recorren memoria local.
+//   - 'wavefront' y 'tiled' recorren diagonales, así que únicamente se reparten las páginas entre los nodos en lugar de concentrarlas en uno.
+//   - La versión serial (sin OpenMP) emplea el mismo tipo, con la inicialización desde un hilo.
+
+// Filas [begin, end) del hilo 'thread' de 'threads' al repartir en bloques contiguos las filas interiores [1, rows-1) de una grilla de 'rows' filas.
+inline void thread_rows(int rows, int thread, int threads, int& begin, int& end){
+  begin = 1 + (int)(((long)thread*(rows-2))/threads);
+  end = 1 + (int)(((long)(thread+1)*(rows-2))/threads);
+}
+
+// Asignador de las grillas contiguas ('GridVector'): reserva la memoria alineada a 64 bytes con 'aligned_alloc' y la escribe por primera vez en paralelo, en bloques contiguos de igual tamaño por hilo,
+// que coinciden con la división de 'thread_rows' salvo a lo sumo una fila en cada frontera. Así cada página queda en el nodo NUMA del hilo que recorre esas filas.
+// 'std::vector' construye sus entradas desde un único hilo, por lo que la construcción sin argumentos no escribe la entrada (la memoria ya está en cero): un vector nuevo de n entradas es nulo,
+// pero 'resize' sobre la capacidad existente conserva los valores previos de esas entradas. Sin OpenMP la memoria se escribe desde un hilo.
+template<typename T>
+struct FirstTouchAllocator{
+  typedef T value_type;
+
+  FirstTouchAllocator() = default;
+  template<typename U>
+  FirstTouchAllocator(const FirstTouchAllocator<U>&){}
+
+  T* allocate(size_t n){
+    size_t bytes = std::max<size_t>((n*sizeof(T) + 63)/64*64, 64);
+    T* data = static_cast<T*>(std::aligned_alloc(64, bytes));
+    if(data == nullptr){
+      throw std::bad_alloc();
+    }
+    #pragma omp parallel if(n*sizeof(T) >= 4096)
+    {
+    size_t thread = 0;
+    size_t threads = 1;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+    threads = omp_get_num_threads();
+#endif
+    std::fill(data + thread*n/threads, data + (thread+1)*n/threads, T());
+    }
+    return data;
+  }
+
+  void deallocate(T* data, size_t){
+    std::free(data);
+  }
+
+  template<typename U>
+  void construct(U* p){
+    ::new((void*)p) U;
+  }
+
+  template<typename U, typename... Args>
+  void construct(U* p, Args&&... args){
+    ::new((void*)p) U(std::forward<Args>(args)...);
+  }
+};
+
+template<typename T, typename U>
+inline bool operator==(const FirstTouchAllocator<T>&, const FirstTouchAllocator<U>&){ return true; }
+template<typename T, typename U>
+inline bool operator!=(const FirstTouchAllocator<T>&, const FirstTouchAllocator<U>&){ return false; }
+
+// Grilla contigua de 'grid_generator' y vectores del mismo tamaño de los solucionadores.
+typedef std::vector<double, FirstTouchAllocator<double>> GridVector;
+
+// Grilla inicial del capacitor: ceros con las líneas de potencial V1 y V2.
+inline GridVector grid_generator(int factor, double V1, double V2, double boundary = 0.0){
+
+  // Manejo de excepciones para evitar factores de escala no válidos.
+  if(factor < 1){
+    std::cerr << "El factor de escala debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+  }
+
+  // Se genera una grilla de dimensiones (10*factor)x(10*factor+1), empleando un vector para que sea contiguo en memoria.
+  int column = 10*factor+1;
+  GridVector phi((size_t)10*factor*column);
+  // Condiciones de frontera, correspondientes a las líneas verticales de potencial.
+  for(int i=2*factor; i < 8*factor; ++i){
+    phi[(size_t)i*column+2*factor] = V1;
+    phi[(size_t)i*column+8*factor] = V2;
+  }
+  return phi;
+}
+
+// Ancho de fila de 'Grid2D' (ver arriba).
+template<typename Real = double>
+inline int grid_stride(int columns){
+  int stride = padded_stride<Real>(columns);
+  if((stride*sizeof(Real)) % 2048 == 0){
+    stride += 64/sizeof(Real);
+  }
+  return stride;
+}
+
+const size_t HUGE_PAGE_BYTES = (size_t)2 << 20;
+
+template<typename Real = double>
+class Grid2D{
+public:
+  // Grilla de 'rows' x 'columns' entradas en cero (incluyendo el relleno).
+  Grid2D(int rows, int columns, bool huge_pages = false) : rows_(rows), columns_(columns), stride_(grid_stride<Real>(columns)){
+    bytes_ = ((size_t)rows_*stride_*sizeof(Real) + 63)/64*64;
+    if(huge_pages){
+      allocate_huge();
+    }
+    if(data_ == nullptr){
+      data_ = static_cast<Real*>(std::aligned_alloc(64, bytes_));
+      if(data_ == nullptr){
+        throw std::bad_alloc();
+      }
+    }
+    for_rows([this](int i){
+      std::fill(row(i), row(i) + stride_, Real(0));
+    });
+  }
+
+  ~Grid2D(){
+    if(mapping_ != nullptr){
+      munmap(mapping_, mapped_);
+    } else{
+      std::free(data_);
+    }
+  }
+
+  Grid2D(const Grid2D&) = delete;
+  Grid2D& operator=(const Grid2D&) = delete;
+
+  int rows() const { return rows_; }
+  int columns() const { return columns_; }
+  int stride() const { return stride_; }
+  // Cantidad de entradas, incluyendo el relleno.
+  size_t size() const { return (size_t)rows_*stride_; }
+  bool huge_pages() const { return mapping_ != nullptr; }
+
+  Real* data(){ return data_; }
+  const Real* data() const { return data_; }
+  Real* row(int i){ return data_ + (size_t)i*stride_; }
+  const Real* row(int i) const { return data_ + (size_t)i*stride_; }
+  Real& operator()(int i, int j){ return data_[(size_t)i*stride_ + j]; }
+  Real operator()(int i, int j) const { return data_[(size_t)i*stride_ + j]; }
+
+  void fill(Real value){
+    for_rows([this, value](int i){
+      std::fill(row(i), row(i) + stride_, value);
+    });
+  }
+
+  // Copia desde una grilla contigua de ancho 'columns' (por ejemplo, la de 'grid_generator'), convirtiendo cada entrada a 'Real'. El relleno no se modifica.
+  template<typename Allocator>
+  void load(const std::vector<double, Allocator>& phi){
+    for_rows([this, &phi](int i){
+      std::copy(phi.begin() + (size_t)i*columns_, phi.begin() + (size_t)(i+1)*columns_, row(i));
+    });
+  }
+
+  // Copia de regreso a una grilla contigua de ancho 'columns', omitiendo el relleno.
+  template<typename Allocator>
+  void store(std::vector<double, Allocator>& phi) const {
+    for_rows([this, &phi](int i){
+      std::copy(row(i), row(i) + columns_, phi.begin() + (size_t)i*columns_);
+    });
+  }
+
+private:
+  // Aplica 'f' a cada fila, en paralelo con la división de 'thread_rows'; las filas de borde corresponden al primer y último hilo.
+  template<typename F>
+  void for_rows(F f) const {
+    if(rows_ < 3){
+      for(int i=0; i < rows_; ++i){
+        f(i);
+      }
+      return;
+    }
+    #pragma omp parallel
+    {
+    int thread = 0;
+    int threads = 1;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+    threads = omp_get_num_threads();
+#endif
+    int begin, end;
+    thread_rows(rows_, thread, threads, begin, end);
+    if(thread == 0){
+      begin = 0;
+    }
+    if(thread == threads-1){
+      end = rows_;
+    }
+    for(int i=begin; i < end; ++i){
+      f(i);
+    }
+    }
+  }
+
+  // Reserva con páginas grandes transparentes, alineada a 2 MB. Si no están disponibles se emplea la reserva común.
+  void allocate_huge(){
+    size_t rounded = (bytes_ + HUGE_PAGE_BYTES-1)/HUGE_PAGE_BYTES*HUGE_PAGE_BYTES;
+    mapped_ = rounded + HUGE_PAGE_BYTES;
+    void* base = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED){
+      std::cerr << "No se pudo reservar la grilla con páginas grandes; se emplean páginas comunes." << std::endl;
+      return;
+    }
+    uintptr_t aligned = ((uintptr_t)base + HUGE_PAGE_BYTES-1)/HUGE_PAGE_BYTES*HUGE_PAGE_BYTES;
+    if(madvise((void*)aligned, rounded, MADV_HUGEPAGE) != 0){
+      std::cerr << "El sistema no admite páginas grandes transparentes; se emplean páginas comunes." << std::endl;
+      munmap(base, mapped_);
+      return;
+    }
+    mapping_ = base;
+    data_ = reinterpret_cast<Real*>(aligned);
+  }
+
+  int rows_;
+  int columns_;
+  int stride_;
+  size_t bytes_ = 0;
+  Real* data_ = nullptr;
+  // Región de 'mmap' cuando se emplean páginas grandes.
+  void* mapping_ = nullptr;
+  size_t mapped_ = 0;
+};
+
+#endif
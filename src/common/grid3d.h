@@ -0,0 +1,210 @@
+#ifndef GRID3D_H
+#define GRID3D_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "grid2d.h"
+#include "grid_output.h"
+
+// Capacitor de placas paralelas finitas en tres dimensiones.
+// La grilla tiene (10*factor) planos k, (10*factor) filas i y (10*factor+1) columnas j: la extensión de la grilla de 'grid_generator', cuyo corte k = 5*factor corresponde a la sección transversal 2D.
+// Las placas son los cuadrados j = 2*factor (potencial V1) y j = 8*factor (potencial V2) con i y k en [2*factor, 8*factor); los seis bordes de la caja están en potencial nulo.
+// La grilla se almacena en un 'Grid2D' cuyas filas son las de todos los planos: la fila i del plano k es la fila k*plane_rows + i, por lo que cada fila inicia en una línea de caché.
+// Si el tamaño de un plano en bytes es múltiplo de 4 KB se agrega una fila de relleno por plano, ya que de lo contrario las entradas (k-1, i, j), (k, i, j) y (k+1, i, j) compiten por los mismos conjuntos de la caché L1.
+
+// Dimensiones de la grilla, o de una franja de planos con planos fantasma (versión distribuida).
+struct Shape3D{
+  int factor = 0;
+  // Planos de la grilla completa.
+  int planes = 0;
+  int rows = 0;
+  int columns = 0;
+  // Ancho de fila y filas por plano en memoria (incluyendo el relleno).
+  int stride = 0;
+  int plane_rows = 0;
+};
+
+inline Shape3D shape_3d(int factor){
+  if(factor < 1){
+    std::cerr << "El factor de escala debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+  }
+  Shape3D shape;
+  shape.factor = factor;
+  shape.planes = 10*factor;
+  shape.rows = 10*factor;
+  shape.columns = 10*factor+1;
+  shape.stride = grid_stride(shape.columns);
+  shape.plane_rows = shape.rows;
+  if(((size_t)shape.rows*shape.stride*sizeof(double)) % 4096 == 0){
+    shape.plane_rows += 1;
+  }
+  return shape;
+}
+
+// Entradas actualizadas por iteración: el interior de la caja sin las dos placas de (6*factor)x(6*factor) entradas.
+inline double updates_3d(const Shape3D& shape){
+  double interior = (double)(shape.planes-2)*(shape.rows-2)*(shape.columns-2);
+  return interior - 2.0*(6.0*shape.factor)*(6.0*shape.factor);
+}
+
+// Bytes de una grilla (o franja) de 'planes' planos, incluyendo el relleno.
+inline double bytes_3d(const Shape3D& shape, int planes){
+  return (double)planes*shape.plane_rows*shape.stride*sizeof(double);
+}
+
+// Fija el potencial de las placas en los planos [0, planes) de 'phi', cuyo plano local 0 es el plano absoluto 'kOffset'.
+inline void set_plates_3d(Grid2D<double>& phi, const Shape3D& shape, int planes, int kOffset, double V1, double V2){
+  int f = shape.factor;
+  for(int k=0; k < planes; ++k){
+    int K = k + kOffset;
+    if(K < 2*f || K >= 8*f){
+      continue;
+    }
+    for(int i=2*f; i < 8*f; ++i){
+      phi(k*shape.plane_rows + i, 2*f) = V1;
+      phi(k*shape.plane_rows + i, 8*f) = V2;
+    }
+  }
+}
+
+// Bloques de la media iteración (2.5D): se recorren los planos de principio a fin sobre un bloque de 'tileRows' x 'tileColumns' entradas, de forma que las filas de los planos k-1, k y k+1 del bloque
+// permanezcan en caché y cada entrada se lea desde memoria una sola vez por media iteración. Con valores nulos se escogen para que tres planos del bloque ocupen 'cache_bytes':
+// primero se reduce el número de filas y, si tres filas completas no caben, también el de columnas (bloqueo 3D).
+inline void tiles_3d(const Shape3D& shape, int& tileRows, int& tileColumns, size_t cache_bytes = 256*1024){
+  size_t budget = cache_bytes/(3*sizeof(double));
+  if(tileColumns <= 0){
+    tileColumns = shape.columns-2;
+    if((size_t)4*shape.stride > budget){
+      tileColumns = std::max(8, (int)(budget/16)/8*8);
+    }
+  }
+  if(tileRows <= 0){
+    tileRows = std::max(1, (int)(budget/(tileColumns+8)) - 2);
+  }
+  tileRows = std::min(tileRows, shape.rows-2);
+  tileColumns = std::min(tileColumns, shape.columns-2);
+}
+
+// Actualización de las entradas j = jFirst, jFirst+2, ... < jEnd de una fila, con los seis vecinos del stencil de siete puntos.
+inline double update_row_3d(double* row, const double* north, const double* south, const double* front, const double* back, int jFirst, int jEnd, double omega){
+  const double a = (1.0+omega)/6.0;
+  double maxDelta = 0.0;
+  for(int j=jFirst; j < jEnd; j += 2){
+    double new_value = a*(north[j] + south[j] + front[j] + back[j] + row[j-1] + row[j+1]) - omega*row[j];
+    maxDelta = std::max(maxDelta, std::abs(new_value - row[j]));
+    row[j] = new_value;
+  }
+  return maxDelta;
+}
+
+// Media iteración rojo-negro con sobre-relajación, u = (1+omega)/6*(vecinos) - omega*u, del color 'color' sobre los planos locales [kBegin, kEnd) de 'phi'.
+// Una entrada (k, i, j) pertenece al color (k + kOffset + i + j)%2, donde 'kOffset' es la posición absoluta del plano local 0; los planos kBegin-1 y kEnd deben existir, ya que se leen como vecinos.
+// Los planos de borde de la caja y las placas no se actualizan. Regresa la mayor diferencia entre el valor nuevo y el anterior.
+inline double sweep_3d(Grid2D<double>& phi, const Shape3D& shape, int kBegin, int kEnd, int kOffset, int color, double omega, int tileRows, int tileColumns){
+  int f = shape.factor;
+  int stride = phi.stride();
+  size_t plane = (size_t)shape.plane_rows*stride;
+  double maxDelta = 0.0;
+  kBegin = std::max(kBegin, 1 - kOffset);
+  kEnd = std::min(kEnd, shape.planes-1 - kOffset);
+  for(int i0=1; i0 < shape.rows-1; i0 += tileRows){
+    int i1 = std::min(i0 + tileRows, shape.rows-1);
+    for(int j0=1; j0 < shape.columns-1; j0 += tileColumns){
+      int j1 = std::min(j0 + tileColumns, shape.columns-1);
+      for(int k=kBegin; k < kEnd; ++k){
+        int K = k + kOffset;
+        bool platePlane = (2*f <= K && K < 8*f);
+        for(int i=i0; i < i1; ++i){
+          double* row = phi.data() + k*plane + (size_t)i*stride;
+          const double* north = row - stride;
+          const double* south = row + stride;
+          const double* front = row - plane;
+          const double* back = row + plane;
+          int j = j0 + ((K + i + j0 + color) & 1);
+          if(platePlane && 2*f <= i && i < 8*f){
+            // Tramos de la fila entre las placas, conservando el color.
+            const int plates[2] = {2*f, 8*f};
+            for(int p=0; p < 2; ++p){
+              int end = std::min(plates[p], j1);
+              if(j < end){
+                maxDelta = std::max(maxDelta, update_row_3d(row, north, south, front, back, j, end, omega));
+                j += (end - j + 1)/2*2;
+              }
+              if(j == plates[p]){
+                j += 2;
+              }
+            }
+          }
+          maxDelta = std::max(maxDelta, update_row_3d(row, north, south, front, back, j, j1, omega));
+        }
+      }
+    }
+  }
+  return maxDelta;
+}
+
+// Copia de los planos [0, planes) sin relleno a 'packed', contiguo en orden (plano, fila, columna).
+inline void pack_3d(const Grid2D<double>& phi, const Shape3D& shape, int firstPlane, int planes, double* packed){
+  for(int k=0; k < planes; ++k){
+    for(int i=0; i < shape.rows; ++i){
+      const double* row = phi.row((firstPlane + k)*shape.plane_rows + i);
+      std::copy(row, row + shape.columns, packed + ((size_t)k*shape.rows + i)*shape.columns);
+    }
+  }
+}
+
+inline bool npy_output(const std::string& path){
+  return path.size() >= 4 && path.compare(path.size()-4, 4, ".npy") == 0;
+}
+
+// Abre 'path' y escribe el encabezado '.npy' del arreglo completo de forma (planos, filas, columnas). Regresa el archivo abierto y en 'header_bytes' la posición donde inician los datos.
+inline std::FILE* open_npy_3d(const std::string& path, const Shape3D& shape, long& header_bytes){
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if(file == NULL){
+    std::cerr << "No se pudo abrir el archivo de salida: " << path << std::endl;
+    exit(1);
+  }
+  write_npy_header(file, "(" + std::to_string(shape.planes) + ", " + std::to_string(shape.rows) + ", " + std::to_string(shape.columns) + ")");
+  header_bytes = std::ftell(file);
+  return file;
+}
+
+// Salida '.npy' del arreglo 3D completo, escrita fila por fila desde la grilla rellena, sin copiarla a un arreglo contiguo.
+inline void write_npy_3d(const std::string& path, const Grid2D<double>& phi, const Shape3D& shape){
+  long header_bytes;
+  std::FILE* file = open_npy_3d(path, shape, header_bytes);
+  for(int k=0; k < shape.planes; ++k){
+    for(int i=0; i < shape.rows; ++i){
+      std::fwrite(phi.row(k*shape.plane_rows + i), sizeof(double), shape.columns, file);
+    }
+  }
+  if(std::fclose(file) != 0){
+    std::cerr << "Error al escribir el archivo de salida: " << path << std::endl;
+    exit(1);
+  }
+}
+
+// Plano central k = 5*factor, contiguo. 'localPlane' es su posición en 'phi' (distinta de 5*factor en las franjas de la versión distribuida).
+inline std::vector<double> middle_plane_3d(const Grid2D<double>& phi, const Shape3D& shape, int localPlane){
+  std::vector<double> plane((size_t)shape.rows*shape.columns);
+  pack_3d(phi, shape, localPlane, 1, plane.data());
+  return plane;
+}
+
+// Salida de la grilla 3D: con extensión '.npy' el arreglo completo ('write_npy_3d'); en otro caso únicamente el corte central k = 5*factor como CSV
+// (en la salida estándar si no hay archivo), con el mismo formato de la solución 2D, de modo que 'plot.py' lo grafica sin cambios. Sólo se copia el plano que se escribe.
+inline void write_grid_3d(const std::string& path, const Grid2D<double>& phi, const Shape3D& shape, int precision = 4){
+  if(npy_output(path)){
+    write_npy_3d(path, phi, shape);
+    return;
+  }
+  write_grid(path, middle_plane_3d(phi, shape, 5*shape.factor), shape.rows, shape.columns, precision);
+}
+
+#endif
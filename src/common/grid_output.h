@@ -0,0 +1,98 @@
+#ifndef GRID_OUTPUT_H
+#define GRID_OUTPUT_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <charconv>
+
+// Escritura de la grilla (rows x columns, contigua por filas) en dos formatos:
+//   - CSV separado por ';', con cada valor convertido mediante 'std::to_chars' y acumulado en un búfer que se escribe en bloques grandes.
+//     Con la precisión 4 por defecto el texto es idéntico al de 'std::cout.precision(4)'.
+//   - Arreglo '.npy' de numpy (versión 1.0, dobles little-endian), que se puede cargar sin copias con 'np.load(archivo, mmap_mode="r")'.
+
+// Tamaño del búfer de escritura del CSV.
+const size_t OUTPUT_BUFFER_BYTES = 1 << 20;
+
+inline void write_csv(std::FILE* file, const double* data, int rows, int columns, int precision = 4){
+  if(precision < 1 || precision > 17){
+    std::cerr << "La precisión de la salida debe estar entre 1 y 17 cifras significativas!" << std::endl;
+    exit(1);
+  }
+  // Se reserva espacio para el valor más largo posible (signo, 17 cifras, punto y exponente) más el separador.
+  const size_t maxValue = 32;
+  std::vector<char> buffer(OUTPUT_BUFFER_BYTES + maxValue);
+  size_t used = 0;
+  for(int i=0; i < rows; ++i){
+    for(int j=0; j < columns; ++j){
+      char* first = buffer.data() + used;
+      std::to_chars_result result = std::to_chars(first, first + maxValue, data[(size_t)i*columns + j], std::chars_format::general, precision);
+      *result.ptr = (j < columns-1) ? ';' : '\n';
+      used = result.ptr + 1 - buffer.data();
+      if(used >= OUTPUT_BUFFER_BYTES){
+        std::fwrite(buffer.data(), 1, used, file);
+        used = 0;
+      }
+    }
+  }
+  std::fwrite(buffer.data(), 1, used, file);
+  std::fflush(file);
+}
+
+// Encabezado '.npy' de un arreglo de dobles con la forma 'shape' (por ejemplo "(10, 11)"); los datos se escriben a continuación en orden C.
+inline void write_npy_header(std::FILE* file, const std::string& shape){
+  const uint16_t probe = 1;
+  if(*(const unsigned char*)&probe != 1){
+    std::cerr << "La salida '.npy' sólo está disponible en arquitecturas little-endian!" << std::endl;
+    exit(1);
+  }
+  // El encabezado es un diccionario de Python rellenado con espacios y terminado en '\n', de forma que los datos inicien en un múltiplo de 64 bytes.
+  std::string header = "{'descr': '<f8', 'fortran_order': False, 'shape': " + shape + ", }";
+  size_t total = 10 + header.size() + 1;
+  header.append((64 - total%64)%64, ' ');
+  header.push_back('\n');
+  uint16_t length = (uint16_t)header.size();
+  std::fwrite("\x93NUMPY\x01\x00", 1, 8, file);
+  std::fwrite(&length, sizeof(length), 1, file);
+  std::fwrite(header.data(), 1, header.size(), file);
+}
+
+inline void write_npy(const std::string& path, const double* data, int rows, int columns){
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if(file == NULL){
+    std::cerr << "No se pudo abrir el archivo de salida: " << path << std::endl;
+    exit(1);
+  }
+  write_npy_header(file, "(" + std::to_string(rows) + ", " + std::to_string(columns) + ")");
+  std::fwrite(data, sizeof(double), (size_t)rows*columns, file);
+  if(std::fclose(file) != 0){
+    std::cerr << "Error al escribir el archivo de salida: " << path << std::endl;
+    exit(1);
+  }
+}
+
+// Escribe la grilla en 'path'; el formato se escoge según la extensión ('.npy' o CSV en cualquier otro caso). Sin archivo, el CSV se escribe en la salida estándar.
+template<typename Allocator>
+inline void write_grid(const std::string& path, const std::vector<double, Allocator>& data, int rows, int columns, int precision = 4){
+  if(path.size() >= 4 && path.compare(path.size()-4, 4, ".npy") == 0){
+    write_npy(path, data.data(), rows, columns);
+    return;
+  }
+  if(path.empty()){
+    std::cout.flush();
+    write_csv(stdout, data.data(), rows, columns, precision);
+    return;
+  }
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  if(file == NULL){
+    std::cerr << "No se pudo abrir el archivo de salida: " << path << std::endl;
+    exit(1);
+  }
+  write_csv(file, data.data(), rows, columns, precision);
+  std::fclose(file);
+}
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef OMEGA_TUNING_H
+#define OMEGA_TUNING_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+// Selección automática del parámetro de sobre-relajación.
+// Para una matriz consistentemente ordenada (la grilla de cinco puntos, tanto en orden lexicográfico como rojo-negro) el parámetro óptimo de SOR es
+//   w_opt = 2/(1 + sqrt(1 - rho^2)),
+// donde 'rho' es el radio espectral de la iteración de Jacobi. En los solucionadores la actualización se escribe como (1+omega)*promedio - omega*phi, por lo que omega = w_opt - 1.
+// 'rho' se estima con iteraciones de Lanczos sobre el operador de Jacobi (promedio de los cuatro vecinos, con las líneas de potencial y los bordes fijos), que es simétrico.
+// El resultado depende únicamente del factor de escala, por lo que se guarda en un archivo de caché y se reutiliza en ejecuciones posteriores.
+
+// Valor de 'omega' que indica que debe escogerse automáticamente ('--omega auto').
+const double AUTO_OMEGA = -1.0;
+// Archivo de caché por defecto, en el directorio de ejecución. Cada línea contiene el factor de escala, omega y el radio espectral.
+const char* const OMEGA_CACHE = "omega_cache.dat";
+
+// Mayor valor propio de la matriz tridiagonal simétrica (diagonal 'a', subdiagonal 'b') mediante bisección con sucesiones de Sturm.
+inline double tridiagonal_max_eigenvalue(const std::vector<double>& a, const std::vector<double>& b){
+  int n = a.size();
+  double hi = -1e300;
+  for(int i=0; i < n; ++i){
+    double radius = (i > 0 ? std::abs(b[i-1]) : 0.0) + (i < n-1 ? std::abs(b[i]) : 0.0);
+    hi = std::max(hi, a[i] + radius);
+  }
+  double lo = -hi;
+  for(int it=0; it < 200 && hi - lo > 1e-15; ++it){
+    double x = 0.5*(lo + hi);
+    // Cantidad de valores propios menores que 'x': pivotes negativos de la factorización de T - xI.
+    int below = 0;
+    double d = 1.0;
+    for(int i=0; i < n; ++i){
+      d = (a[i] - x) - (i > 0 ? b[i-1]*b[i-1]/d : 0.0);
+      if(d == 0.0){
+        d = 1e-300;
+      }
+      if(d < 0.0){
+        below++;
+      }
+    }
+    if(below == n){
+      hi = x;
+    } else{
+      lo = x;
+    }
+  }
+  return 0.5*(lo + hi);
+}
+
+// Radio espectral de la iteración de Jacobi para la grilla del capacitor con el factor de escala dado.
+// Se detiene cuando la estimación de 1 - rho cambia menos de 0.1% en diez pasos, o tras 'maxSteps' pasos; 'steps' regresa la cantidad de barridos empleados.
+inline double jacobi_spectral_radius(int factor, int& steps, int maxSteps = 0){
+  int rows = 10*factor;
+  int column = 10*factor+1;
+  if(maxSteps <= 0){
+    maxSteps = std::max(200, 40*factor);
+  }
+  size_t n = (size_t)rows*column;
+  std::vector<char> fixed(n, 0);
+  for(int i=0; i < rows; ++i){
+    for(int j=0; j < column; ++j){
+      bool border = (i == 0 || j == 0 || i == rows-1 || j == column-1);
+      bool plate = (2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor);
+      fixed[(size_t)i*column + j] = (border || plate);
+    }
+  }
+
+  // Vector inicial: unos en las entradas libres (tiene una componente grande sobre el modo principal, que es positivo).
+  std::vector<double> v(n, 0.0), previous(n, 0.0), w(n, 0.0);
+  double norm = 0.0;
+  for(size_t k=0; k < n; ++k){
+    v[k] = fixed[k] ? 0.0 : 1.0;
+    norm += v[k];
+  }
+  norm = std::sqrt(norm);
+  for(double& x : v){
+    x /= norm;
+  }
+
+  std::vector<double> alpha, beta;
+  double rho = 0.0;
+  std::vector<double> history;
+  double b = 0.0;
+  for(steps=1; steps <= maxSteps; ++steps){
+    // w = J v, con las entradas fijas en cero.
+    for(int i=1; i < rows-1; ++i){
+      for(int j=1; j < column-1; ++j){
+        size_t k = (size_t)i*column + j;
+        w[k] = fixed[k] ? 0.0 : 0.25*(v[k-1] + v[k+1] + v[k-column] + v[k+column]);
+      }
+    }
+    double a = 0.0;
+    for(size_t k=0; k < n; ++k){
+      a += w[k]*v[k];
+    }
+    double next = 0.0;
+    for(size_t k=0; k < n; ++k){
+      w[k] -= a*v[k] + b*previous[k];
+      next += w[k]*w[k];
+    }
+    alpha.push_back(a);
+    rho = tridiagonal_max_eigenvalue(alpha, beta);
+    history.push_back(1.0 - rho);
+    if(steps > 10 && std::abs(history[steps-1] - history[steps-11]) < 1e-3*history[steps-1]){
+      break;
+    }
+    b = std::sqrt(next);
+    if(b == 0.0){
+      break;
+    }
+    beta.push_back(b);
+    previous.swap(v);
+    for(size_t k=0; k < n; ++k){
+      v[k] = w[k]/b;
+    }
+  }
+  steps = std::min(steps, maxSteps);
+  return rho;
+}
+
+// Parámetro 'omega' de los solucionadores (w_opt - 1) a partir del radio espectral de Jacobi.
+inline double optimal_omega(double rho){
+  return 2.0/(1.0 + std::sqrt(1.0 - rho*rho)) - 1.0;
+}
+
+// Omega óptimo para el factor de escala dado. Si el factor ya se encuentra en el archivo de caché se reutiliza; de lo contrario se estima y se agrega al archivo.
+// Se reporta en la salida de error el valor escogido y su origen.
+inline double auto_omega(int factor, const std::string& path = OMEGA_CACHE){
+  std::ifstream in(path);
+  std::string line;
+  while(std::getline(in, line)){
+    std::istringstream fields(line);
+    int cachedFactor;
+    double omega, rho;
+    if(line.empty() || line[0] == '#' || !(fields >> cachedFactor >> omega >> rho)){
+      continue;
+    }
+    if(cachedFactor == factor){
+      std::cerr << "Omega automático: " << omega << "; Radio espectral de Jacobi: " << rho << "; Origen: " << path << std::endl;
+      return omega;
+    }
+  }
+  in.close();
+
+  int steps;
+  double rho = jacobi_spectral_radius(factor, steps);
+  double omega = optimal_omega(rho);
+  std::cerr << "Omega automático: " << omega << "; Radio espectral de Jacobi: " << rho << "; Origen: estimación con " << steps << " iteraciones de Lanczos" << std::endl;
+
+  std::ofstream out(path, std::ios::app);
+  if(out){
+    out.precision(17);
+    out << factor << " " << omega << " " << rho << std::endl;
+  } else{
+    std::cerr << "No se pudo escribir el archivo de caché: " << path << std::endl;
+  }
+  return omega;
+}
+
+// Interpreta el argumento de '--omega': un número o 'auto'.
+inline double parse_omega(const std::string& text){
+  if(text == "auto"){
+    return AUTO_OMEGA;
+  }
+  return std::stod(text);
+}
+
+#endif
@@ -0,0 +1,380 @@
+#ifndef STENCIL_KERNEL_H
+#define STENCIL_KERNEL_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <immintrin.h>
+
+// Kernel vectorizado de cinco puntos para las iteraciones rojo-negro de Gauss-Seidel/SOR.
+// Las entradas fijas (bordes y líneas de potencial) se manejan mediante una máscara precalculada: un bit encendido para las entradas que se actualizan y apagado para las fijas y el relleno.
+// De esta forma el ciclo interno no contiene la condición de las líneas de potencial y puede vectorizarse. El conjunto de instrucciones (AVX-512, AVX2 o escalar) se escoge al momento de ejecución.
+// Los kernels existen en doble ('double') y simple ('float') precisión: en simple precisión cada barrido mueve la mitad de los bytes y cada registro procesa el doble de columnas.
+
+// Ancho de fila mínimo de una grilla rellena: el número de columnas se redondea a un múltiplo de 64 bytes (8 dobles o 16 flotantes), de forma que cada fila inicie alineada.
+// Las grillas rellenas de los solucionadores son las de 'grid2d.h'.
+template<typename Real = double>
+inline int padded_stride(int columns){
+  const int lanes = 64/sizeof(Real);
+  return (columns + lanes-1)/lanes*lanes;
+}
+
+// Número de bytes por fila de la máscara: un bit por entrada.
+inline int mask_row_bytes(int stride){
+  return (stride + 7)/8;
+}
+
+// Máscara de las entradas que se actualizan en el capacitor: el interior de la grilla, exceptuando las líneas de potencial.
+// Se almacena un bit por entrada, de forma que su lectura sea despreciable frente a la de la grilla: el bit j%8 del byte j/8 de cada fila.
+// 'rowOffset' es la posición absoluta de la fila local 0, para las grillas locales de la versión distribuida.
+inline std::vector<unsigned char> capacitor_mask(int rows, int columns, int stride, int factor, int rowOffset = 0){
+  int rowBytes = mask_row_bytes(stride);
+  std::vector<unsigned char> mask((size_t)rows*rowBytes, 0);
+  for(int i=0; i < rows; ++i){
+    int absolute_position = i + rowOffset;
+    if(absolute_position < 1 || absolute_position > 10*factor-2){
+      continue;
+    }
+    for(int j=1; j < columns-1; ++j){
+      bool plate = (2*factor <= absolute_position && absolute_position < 8*factor) && (j == 2*factor || j == 8*factor);
+      if(!plate){
+        mask[(size_t)i*rowBytes + j/8] |= (unsigned char)(1 << (j%8));
+      }
+    }
+  }
+  return mask;
+}
+
+// Firma de los kernels: media iteración del color 'color' sobre las filas [rowBegin, rowEnd) de la grilla 'phi' con ancho de fila 'stride'.
+// Una entrada (i,j) pertenece al color (i + rowOffset + j)%2. Las filas rowBegin-1 y rowEnd deben existir, ya que se leen como vecinas.
+// Regresa la mayor diferencia entre el valor nuevo y el anterior de las entradas actualizadas.
+template<typename Real>
+using HalfSweep = Real (*)(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega);
+typedef HalfSweep<double> HalfSweepKernel;
+// Variante con término fuente 'source' (con el mismo ancho de fila que 'phi') para la ecuación 4*u - vecinos = source: u = (1+omega)/4*(vecinos + source) - omega*u.
+// Se emplea en las ecuaciones de corrección del refinamiento iterativo, con la misma convención que el suavizador de multigrid.
+template<typename Real>
+using HalfSweepSource = Real (*)(Real* phi, const Real* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega);
+// Variante restringida a las columnas [colBegin, colEnd) de cada fila, para los bloques bidimensionales del modo incremental ('active_tiles.h').
+// 'colBegin' debe ser múltiplo de 16 y 'colEnd' múltiplo de 16 o igual a 'stride', de forma que los bloques coincidan con los registros y con los bytes de la máscara.
+template<typename Real>
+using HalfSweepColumns = Real (*)(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, Real omega);
+
+// Versión escalar. La selección entre el valor nuevo y el anterior se compila como una instrucción de selección, sin saltos.
+template<typename Real, bool Source>
+inline Real half_sweep_scalar_impl(Real* phi, const Real* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, Real omega){
+  Real w = (Real(1)+omega)*Real(0.25);
+  Real maxDelta = 0;
+  int rowBytes = mask_row_bytes(stride);
+  for(int i=rowBegin; i < rowEnd; ++i){
+    Real* row = phi + (size_t)i*stride;
+    const Real* f = Source ? source + (size_t)i*stride : nullptr;
+    const unsigned char* m = mask + (size_t)i*rowBytes;
+    for(int j=colBegin + (color + i + rowOffset + colBegin)%2; j < colEnd; j += 2){
+      Real old_value = row[j];
+      Real sum = (row[j-stride] + row[j+stride]) + (row[j-1] + row[j+1]);
+      if constexpr(Source){
+        sum += f[j];
+      }
+      Real new_value = w*sum - omega*old_value;
+      bool update = (m[j/8] >> (j%8)) & 1;
+      maxDelta = std::max(maxDelta, update ? std::abs(new_value - old_value) : Real(0));
+      row[j] = update ? new_value : old_value;
+    }
+  }
+  return maxDelta;
+}
+
+template<typename Real>
+inline Real half_sweep_scalar(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega){
+  return half_sweep_scalar_impl<Real, false>(phi, nullptr, mask, stride, rowBegin, rowEnd, 0, stride, rowOffset, color, omega);
+}
+
+template<typename Real>
+inline Real half_sweep_scalar_columns(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, Real omega){
+  return half_sweep_scalar_impl<Real, false>(phi, nullptr, mask, stride, rowBegin, rowEnd, colBegin, colEnd, rowOffset, color, omega);
+}
+
+template<typename Real>
+inline Real half_sweep_scalar_source(Real* phi, const Real* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega){
+  return half_sweep_scalar_impl<Real, true>(phi, source, mask, stride, rowBegin, rowEnd, 0, stride, rowOffset, color, omega);
+}
+
+// Versión AVX2: se procesan cuatro columnas contiguas a la vez y se escriben únicamente las del color correspondiente que no son fijas ('maskstore').
+// Los vecinos izquierdo y derecho se obtienen desplazando los registros del bloque anterior, actual y siguiente. Leerlos nuevamente de memoria traslaparía la escritura del bloque anterior, lo cual detiene el procesador hasta que esta finaliza.
+template<bool Source>
+__attribute__((target("avx2")))
+inline double half_sweep_avx2_impl(double* phi, const double* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, double omega){
+  const __m256d w = _mm256_set1_pd((1.0+omega)*0.25);
+  const __m256d om = _mm256_set1_pd(omega);
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  // Bit de la máscara que corresponde a cada carril.
+  const __m256i laneBits = _mm256_setr_epi64x(1, 2, 4, 8);
+  __m256d maxVector = _mm256_setzero_pd();
+  double maxDelta = 0.0;
+  double ws = (1.0+omega)*0.25;
+  int rowBytes = mask_row_bytes(stride);
+  int vectorEnd = colEnd - (colEnd - colBegin)%4;
+  for(int i=rowBegin; i < rowEnd; ++i){
+    double* row = phi + (size_t)i*stride;
+    const double* f = Source ? source + (size_t)i*stride : nullptr;
+    const unsigned char* m = mask + (size_t)i*rowBytes;
+    int parity = (color + i + rowOffset)%2;
+    // Carriles del color correspondiente dentro de un bloque de cuatro columnas que inicia en una columna par.
+    int colorBits = (parity == 0) ? 0x5 : 0xA;
+    __m256d previous = _mm256_loadu_pd(row + colBegin - 4);
+    __m256d center = _mm256_loadu_pd(row + colBegin);
+    for(int j=colBegin; j < vectorEnd; j += 4){
+      __m256d next = _mm256_loadu_pd(row + j + 4);
+      // left = [previous[3], center[0], center[1], center[2]], right = [center[1], center[2], center[3], next[0]].
+      __m256d left = _mm256_shuffle_pd(_mm256_permute2f128_pd(previous, center, 0x21), center, 0x5);
+      __m256d right = _mm256_shuffle_pd(center, _mm256_permute2f128_pd(center, next, 0x21), 0x5);
+      __m256d sum = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(row + j - stride), _mm256_loadu_pd(row + j + stride)), _mm256_add_pd(left, right));
+      if constexpr(Source){
+        sum = _mm256_add_pd(sum, _mm256_loadu_pd(f + j));
+      }
+      __m256d new_value = _mm256_sub_pd(_mm256_mul_pd(w, sum), _mm256_mul_pd(om, center));
+      int bits = ((m[j/8] >> (j%8)) & colorBits);
+      __m256i update = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), laneBits), laneBits);
+      maxVector = _mm256_max_pd(maxVector, _mm256_and_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(new_value, center)), _mm256_castsi256_pd(update)));
+      _mm256_maskstore_pd(row + j, update, new_value);
+      previous = center;
+      center = next;
+    }
+    // Columnas restantes cuando 'stride' no es múltiplo de cuatro.
+    for(int j=vectorEnd + parity; j < colEnd; j += 2){
+      double old_value = row[j];
+      double sum = (row[j-stride] + row[j+stride]) + (row[j-1] + row[j+1]);
+      if constexpr(Source){
+        sum += f[j];
+      }
+      double new_value = ws*sum - omega*old_value;
+      bool update = (m[j/8] >> (j%8)) & 1;
+      maxDelta = std::max(maxDelta, update ? std::abs(new_value - old_value) : 0.0);
+      row[j] = update ? new_value : old_value;
+    }
+  }
+  double lanesMax[4];
+  _mm256_storeu_pd(lanesMax, maxVector);
+  for(int k=0; k < 4; ++k){
+    maxDelta = std::max(maxDelta, lanesMax[k]);
+  }
+  return maxDelta;
+}
+
+// Versión AVX2 en simple precisión: ocho columnas por registro. Los desplazamientos de un carril combinan 'permute2f128' con 'alignr_epi8', que opera sobre cada mitad de 128 bits.
+// Como 'stride' es múltiplo de 16, cada bloque de ocho columnas corresponde exactamente a un byte de la máscara.
+template<bool Source>
+__attribute__((target("avx2")))
+inline float half_sweep_avx2_impl(float* phi, const float* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, float omega){
+  const __m256 w = _mm256_set1_ps((1.0f+omega)*0.25f);
+  const __m256 om = _mm256_set1_ps(omega);
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  __m256 maxVector = _mm256_setzero_ps();
+  int rowBytes = mask_row_bytes(stride);
+  for(int i=rowBegin; i < rowEnd; ++i){
+    float* row = phi + (size_t)i*stride;
+    const float* f = Source ? source + (size_t)i*stride : nullptr;
+    const unsigned char* m = mask + (size_t)i*rowBytes;
+    int parity = (color + i + rowOffset)%2;
+    int colorBits = (parity == 0) ? 0x55 : 0xAA;
+    __m256 previous = _mm256_loadu_ps(row + colBegin - 8);
+    __m256 center = _mm256_loadu_ps(row + colBegin);
+    for(int j=colBegin; j < colEnd; j += 8){
+      __m256 next = _mm256_loadu_ps(row + j + 8);
+      // left = [previous[7], center[0..6]], right = [center[1..7], next[0]].
+      __m256i low = _mm256_castps_si256(_mm256_permute2f128_ps(previous, center, 0x21));
+      __m256i high = _mm256_castps_si256(_mm256_permute2f128_ps(center, next, 0x21));
+      __m256 left = _mm256_castsi256_ps(_mm256_alignr_epi8(_mm256_castps_si256(center), low, 12));
+      __m256 right = _mm256_castsi256_ps(_mm256_alignr_epi8(high, _mm256_castps_si256(center), 4));
+      __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(row + j - stride), _mm256_loadu_ps(row + j + stride)), _mm256_add_ps(left, right));
+      if constexpr(Source){
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(f + j));
+      }
+      __m256 new_value = _mm256_sub_ps(_mm256_mul_ps(w, sum), _mm256_mul_ps(om, center));
+      __m256i update = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(m[j/8] & colorBits), laneBits), laneBits);
+      maxVector = _mm256_max_ps(maxVector, _mm256_and_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(new_value, center)), _mm256_castsi256_ps(update)));
+      _mm256_maskstore_ps(row + j, update, new_value);
+      previous = center;
+      center = next;
+    }
+  }
+  float lanesMax[8];
+  _mm256_storeu_ps(lanesMax, maxVector);
+  float maxDelta = 0.0f;
+  for(int k=0; k < 8; ++k){
+    maxDelta = std::max(maxDelta, lanesMax[k]);
+  }
+  return maxDelta;
+}
+
+// Versión AVX-512: se procesan ocho columnas a la vez. Cada byte de la máscara corresponde directamente a un registro de máscara de ocho carriles.
+template<bool Source>
+__attribute__((target("avx512f")))
+inline double half_sweep_avx512_impl(double* phi, const double* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, double omega){
+  const __m512d w = _mm512_set1_pd((1.0+omega)*0.25);
+  const __m512d om = _mm512_set1_pd(omega);
+  __m512d maxVector = _mm512_setzero_pd();
+  double maxDelta = 0.0;
+  double ws = (1.0+omega)*0.25;
+  int rowBytes = mask_row_bytes(stride);
+  int vectorEnd = colEnd - (colEnd - colBegin)%8;
+  for(int i=rowBegin; i < rowEnd; ++i){
+    double* row = phi + (size_t)i*stride;
+    const double* f = Source ? source + (size_t)i*stride : nullptr;
+    const unsigned char* m = mask + (size_t)i*rowBytes;
+    int parity = (color + i + rowOffset)%2;
+    // Bits de los carriles pares (0x55) o impares (0xAA).
+    __mmask8 colorBits = (parity == 0) ? 0x55 : 0xAA;
+    __m512d previous = _mm512_loadu_pd(row + colBegin - 8);
+    __m512d center = _mm512_loadu_pd(row + colBegin);
+    for(int j=colBegin; j < vectorEnd; j += 8){
+      __m512d next = _mm512_loadu_pd(row + j + 8);
+      __m512d left = _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(center), _mm512_castpd_si512(previous), 7));
+      __m512d right = _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(next), _mm512_castpd_si512(center), 1));
+      __m512d sum = _mm512_add_pd(_mm512_add_pd(_mm512_loadu_pd(row + j - stride), _mm512_loadu_pd(row + j + stride)), _mm512_add_pd(left, right));
+      if constexpr(Source){
+        sum = _mm512_add_pd(sum, _mm512_loadu_pd(f + j));
+      }
+      __m512d new_value = _mm512_sub_pd(_mm512_mul_pd(w, sum), _mm512_mul_pd(om, center));
+      __mmask8 update = m[j/8] & colorBits;
+      maxVector = _mm512_mask_max_pd(maxVector, update, maxVector, _mm512_abs_pd(_mm512_sub_pd(new_value, center)));
+      _mm512_mask_storeu_pd(row + j, update, new_value);
+      previous = center;
+      center = next;
+    }
+    for(int j=vectorEnd + parity; j < colEnd; j += 2){
+      double old_value = row[j];
+      double sum = (row[j-stride] + row[j+stride]) + (row[j-1] + row[j+1]);
+      if constexpr(Source){
+        sum += f[j];
+      }
+      double new_value = ws*sum - omega*old_value;
+      bool update = (m[j/8] >> (j%8)) & 1;
+      maxDelta = std::max(maxDelta, update ? std::abs(new_value - old_value) : 0.0);
+      row[j] = update ? new_value : old_value;
+    }
+  }
+  double lanesMax[8];
+  _mm512_storeu_pd(lanesMax, maxVector);
+  for(int k=0; k < 8; ++k){
+    maxDelta = std::max(maxDelta, lanesMax[k]);
+  }
+  return maxDelta;
+}
+
+// Versión AVX-512 en simple precisión: dieciséis columnas por registro, cuya máscara son dos bytes consecutivos de la máscara de la fila.
+template<bool Source>
+__attribute__((target("avx512f")))
+inline float half_sweep_avx512_impl(float* phi, const float* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, float omega){
+  const __m512 w = _mm512_set1_ps((1.0f+omega)*0.25f);
+  const __m512 om = _mm512_set1_ps(omega);
+  __m512 maxVector = _mm512_setzero_ps();
+  int rowBytes = mask_row_bytes(stride);
+  for(int i=rowBegin; i < rowEnd; ++i){
+    float* row = phi + (size_t)i*stride;
+    const float* f = Source ? source + (size_t)i*stride : nullptr;
+    const unsigned char* m = mask + (size_t)i*rowBytes;
+    int parity = (color + i + rowOffset)%2;
+    __mmask16 colorBits = (parity == 0) ? 0x5555 : 0xAAAA;
+    __m512 previous = _mm512_loadu_ps(row + colBegin - 16);
+    __m512 center = _mm512_loadu_ps(row + colBegin);
+    for(int j=colBegin; j < colEnd; j += 16){
+      __m512 next = _mm512_loadu_ps(row + j + 16);
+      __m512 left = _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(center), _mm512_castps_si512(previous), 15));
+      __m512 right = _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(next), _mm512_castps_si512(center), 1));
+      __m512 sum = _mm512_add_ps(_mm512_add_ps(_mm512_loadu_ps(row + j - stride), _mm512_loadu_ps(row + j + stride)), _mm512_add_ps(left, right));
+      if constexpr(Source){
+        sum = _mm512_add_ps(sum, _mm512_loadu_ps(f + j));
+      }
+      __m512 new_value = _mm512_sub_ps(_mm512_mul_ps(w, sum), _mm512_mul_ps(om, center));
+      __mmask16 update = (m[j/8] | (m[j/8+1] << 8)) & colorBits;
+      maxVector = _mm512_mask_max_ps(maxVector, update, maxVector, _mm512_abs_ps(_mm512_sub_ps(new_value, center)));
+      _mm512_mask_storeu_ps(row + j, update, new_value);
+      previous = center;
+      center = next;
+    }
+  }
+  float lanesMax[16];
+  _mm512_storeu_ps(lanesMax, maxVector);
+  float maxDelta = 0.0f;
+  for(int k=0; k < 16; ++k){
+    maxDelta = std::max(maxDelta, lanesMax[k]);
+  }
+  return maxDelta;
+}
+
+// Puntos de entrada de los kernels vectorizados, con y sin término fuente y restringidos a un rango de columnas, para ambas precisiones.
+template<typename Real>
+inline Real half_sweep_avx2(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega){
+  return half_sweep_avx2_impl<false>(phi, nullptr, mask, stride, rowBegin, rowEnd, 0, stride, rowOffset, color, omega);
+}
+
+template<typename Real>
+inline Real half_sweep_avx2_source(Real* phi, const Real* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega){
+  return half_sweep_avx2_impl<true>(phi, source, mask, stride, rowBegin, rowEnd, 0, stride, rowOffset, color, omega);
+}
+
+template<typename Real>
+inline Real half_sweep_avx2_columns(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, Real omega){
+  return half_sweep_avx2_impl<false>(phi, nullptr, mask, stride, rowBegin, rowEnd, colBegin, colEnd, rowOffset, color, omega);
+}
+
+template<typename Real>
+inline Real half_sweep_avx512(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega){
+  return half_sweep_avx512_impl<false>(phi, nullptr, mask, stride, rowBegin, rowEnd, 0, stride, rowOffset, color, omega);
+}
+
+template<typename Real>
+inline Real half_sweep_avx512_source(Real* phi, const Real* source, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int rowOffset, int color, Real omega){
+  return half_sweep_avx512_impl<true>(phi, source, mask, stride, rowBegin, rowEnd, 0, stride, rowOffset, color, omega);
+}
+
+template<typename Real>
+inline Real half_sweep_avx512_columns(Real* phi, const unsigned char* mask, int stride, int rowBegin, int rowEnd, int colBegin, int colEnd, int rowOffset, int color, Real omega){
+  return half_sweep_avx512_impl<false>(phi, nullptr, mask, stride, rowBegin, rowEnd, colBegin, colEnd, rowOffset, color, omega);
+}
+
+// Kernel seleccionado, junto con su nombre para los reportes.
+template<typename Real>
+struct BasicStencilKernel{
+  std::string name;
+  HalfSweep<Real> sweep;
+  HalfSweepSource<Real> sweep_source;
+  HalfSweepColumns<Real> sweep_columns;
+};
+typedef BasicStencilKernel<double> StencilKernel;
+
+// Selección del kernel. Con 'auto' se escoge el mejor conjunto de instrucciones disponible en el procesador; también se puede forzar 'avx512', 'avx2' o 'scalar'.
+// 'Real' escoge la precisión de la grilla ('double' por defecto o 'float').
+template<typename Real = double>
+inline BasicStencilKernel<Real> select_kernel(const std::string& name = "auto"){
+  __builtin_cpu_init();
+  bool avx512 = __builtin_cpu_supports("avx512f");
+  bool avx2 = __builtin_cpu_supports("avx2");
+  if(name == "avx512" || (name == "auto" && avx512)){
+    if(!avx512){
+      std::cerr << "El procesador no soporta instrucciones AVX-512!" << std::endl;
+      exit(1);
+    }
+    return {"avx512", half_sweep_avx512<Real>, half_sweep_avx512_source<Real>, half_sweep_avx512_columns<Real>};
+  }
+  if(name == "avx2" || (name == "auto" && avx2)){
+    if(!avx2){
+      std::cerr << "El procesador no soporta instrucciones AVX2!" << std::endl;
+      exit(1);
+    }
+    return {"avx2", half_sweep_avx2<Real>, half_sweep_avx2_source<Real>, half_sweep_avx2_columns<Real>};
+  }
+  if(name == "scalar" || name == "auto"){
+    return {"scalar", half_sweep_scalar<Real>, half_sweep_scalar_source<Real>, half_sweep_scalar_columns<Real>};
+  }
+  std::cerr << "Kernel no reconocido: " << name << ". Las opciones son 'auto', 'avx512', 'avx2' y 'scalar'." << std::endl;
+  exit(1);
+}
+
+#endif
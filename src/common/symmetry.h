@@ -0,0 +1,152 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include "stencil_kernel.h"
+
+// Simetrías de la grilla de 'grid_generator' y solución sobre el dominio reducido.
+// La grilla de (10*factor)x(10*factor+1) con las líneas en las columnas 2*factor y 8*factor (filas [2*factor, 8*factor)) es simétrica respecto del plano entre las filas 5*factor-1 y 5*factor:
+// phi(i, j) = phi(10*factor-1-i, j) para cualquier par de voltajes. Si además V1 = -V2 es antisimétrica respecto de la columna 5*factor (phi(i, 10*factor-j) = -phi(i, j), con la columna 5*factor nula),
+// y si V1 = V2 es simétrica respecto de la misma columna.
+// El dominio reducido contiene las filas [0, 5*factor) y, en el caso de un cuarto, las columnas [0, 5*factor]. Las condiciones sobre los planos de simetría son:
+//   - Plano horizontal (Neumann): una fila espejo adicional (la última de la grilla reducida) que se copia de la fila 5*factor-1 después de cada media iteración.
+//   - Plano vertical antisimétrico: la columna 5*factor es la última columna de la grilla reducida y queda fija en cero, como un borde.
+//   - Plano vertical simétrico (Neumann): la columna 5*factor se actualiza y se agrega una columna espejo (5*factor+1) que se copia de la columna 5*factor-1.
+// Las entradas espejo están excluidas de la máscara de los kernels, por lo que los barridos de 'stencil_kernel.h' se aplican sin cambios; la grilla completa se reconstruye al final con 'expand_grid'.
+
+enum SymmetryMode{ SYMMETRY_NONE, SYMMETRY_HALF, SYMMETRY_QUARTER };
+
+// Dominio reducido. 'rows' y 'columns' incluyen la fila y columna espejo.
+struct SymmetryDomain{
+  int mode = SYMMETRY_NONE;
+  int factor = 0;
+  // Signo de la simetría respecto de la columna 5*factor en un cuarto de dominio: -1 si V1 = -V2 y +1 si V1 = V2.
+  int sign = -1;
+  int rows = 0;
+  int columns = 0;
+};
+
+// Dominio a partir del nombre de la opción '--simetria': 'ninguna', 'mitad', 'cuarto' o 'auto' (un cuarto si V1 = -V2 o V1 = V2, y una mitad en otro caso).
+inline SymmetryDomain symmetry_domain(const std::string& name, int factor, double V1, double V2){
+  SymmetryDomain domain;
+  domain.factor = factor;
+  domain.rows = 10*factor;
+  domain.columns = 10*factor+1;
+  bool vertical = (V1 == -V2 || V1 == V2);
+  if(name == "ninguna"){
+    return domain;
+  } else if(name == "mitad" || (name == "auto" && !vertical)){
+    domain.mode = SYMMETRY_HALF;
+  } else if(name == "cuarto" || name == "auto"){
+    if(!vertical){
+      std::cerr << "El cuarto de dominio requiere V1 = -V2 (antisimetría) o V1 = V2 (simetría); se puede emplear '--simetria mitad'!" << std::endl;
+      exit(1);
+    }
+    domain.mode = SYMMETRY_QUARTER;
+    domain.sign = (V1 == V2) ? 1 : -1;
+  } else{
+    std::cerr << "Simetría no reconocida: " << name << ". Las opciones son 'ninguna', 'mitad', 'cuarto' y 'auto'." << std::endl;
+    exit(1);
+  }
+  domain.rows = 5*factor+1;
+  if(domain.mode == SYMMETRY_QUARTER){
+    domain.columns = (domain.sign < 0) ? 5*factor+1 : 5*factor+2;
+  }
+  return domain;
+}
+
+inline const char* symmetry_name(const SymmetryDomain& domain){
+  static const char* names[3] = {"ninguna", "mitad", "cuarto"};
+  return names[domain.mode];
+}
+
+// Máscara de los kernels sobre la grilla reducida (o una franja de ella que inicia en la fila absoluta 'rowOffset'): la de 'capacitor_mask' sin la fila espejo.
+inline std::vector<unsigned char> symmetry_mask(const SymmetryDomain& domain, int rows, int stride, int rowOffset = 0){
+  std::vector<unsigned char> mask = capacitor_mask(rows, domain.columns, stride, domain.factor, rowOffset);
+  int rowBytes = mask_row_bytes(stride);
+  for(int i=0; i < rows; ++i){
+    if(i + rowOffset >= domain.rows-1){
+      std::fill(mask.begin() + (size_t)i*rowBytes, mask.begin() + (size_t)(i+1)*rowBytes, 0);
+    }
+  }
+  return mask;
+}
+
+// Copia de la columna espejo en las filas [rowBegin, rowEnd) (sólo en un cuarto de dominio simétrico).
+template<typename Real>
+inline void mirror_columns(Real* phi, int stride, int rowBegin, int rowEnd, const SymmetryDomain& domain){
+  if(domain.mode != SYMMETRY_QUARTER || domain.sign < 0){
+    return;
+  }
+  int c = domain.columns;
+  for(int i=rowBegin; i < rowEnd; ++i){
+    phi[(size_t)i*stride + c-1] = phi[(size_t)i*stride + c-3];
+  }
+}
+
+// Copia de la fila espejo 'ghost' desde la fila anterior.
+template<typename Real>
+inline void mirror_row(Real* phi, int stride, int ghost, const SymmetryDomain& domain){
+  std::copy(phi + (size_t)(ghost-1)*stride, phi + (size_t)(ghost-1)*stride + domain.columns, phi + (size_t)ghost*stride);
+}
+
+// Actualiza las entradas espejo de la grilla reducida completa; se llama después de cada media iteración.
+template<typename Real>
+inline void refresh_mirror(Real* phi, int stride, const SymmetryDomain& domain){
+  if(domain.mode == SYMMETRY_NONE){
+    return;
+  }
+  mirror_columns(phi, stride, 1, domain.rows-1, domain);
+  mirror_row(phi, stride, domain.rows-1, domain);
+}
+
+// Grilla reducida (contigua, de 'domain.rows' x 'domain.columns') a partir de la grilla completa, con el mismo tipo de vector.
+template<typename Allocator>
+inline std::vector<double, Allocator> reduce_grid(const std::vector<double, Allocator>& phi, const SymmetryDomain& domain){
+  int column = 10*domain.factor+1;
+  std::vector<double, Allocator> reduced((size_t)domain.rows*domain.columns, 0.0);
+  for(int i=0; i < domain.rows-1; ++i){
+    for(int j=0; j < std::min(domain.columns, column); ++j){
+      reduced[(size_t)i*domain.columns + j] = phi[(size_t)i*column + j];
+    }
+  }
+  // En un cuarto de dominio antisimétrico la columna 5*factor es nula.
+  if(domain.mode == SYMMETRY_QUARTER && domain.sign < 0){
+    for(int i=0; i < domain.rows; ++i){
+      reduced[(size_t)i*domain.columns + domain.columns-1] = 0.0;
+    }
+  }
+  refresh_mirror(reduced.data(), domain.columns, domain);
+  return reduced;
+}
+
+// Grilla completa a partir de la reducida, aplicando las simetrías del dominio. Se regresa con el mismo tipo de vector de la grilla reducida.
+template<typename Allocator>
+inline std::vector<double, Allocator> expand_grid(const std::vector<double, Allocator>& reduced, const SymmetryDomain& domain){
+  int f = domain.factor;
+  int rows = 10*f;
+  int column = 10*f+1;
+  if(domain.mode == SYMMETRY_NONE){
+    return reduced;
+  }
+  std::vector<double, Allocator> phi((size_t)rows*column);
+  for(int i=0; i < 5*f; ++i){
+    for(int j=0; j < column; ++j){
+      double value;
+      if(domain.mode == SYMMETRY_HALF || j <= 5*f){
+        value = reduced[(size_t)i*domain.columns + j];
+      } else{
+        value = domain.sign*reduced[(size_t)i*domain.columns + (10*f - j)];
+      }
+      phi[(size_t)i*column + j] = value;
+      phi[(size_t)(rows-1-i)*column + j] = value;
+    }
+  }
+  return phi;
+}
+
+#endif
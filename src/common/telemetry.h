@@ -0,0 +1,315 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+// Telemetría por iteración de los solucionadores: tiempo de cada fase, historial del residuo y, opcionalmente, contadores de hardware.
+// Sólo existe al compilar con '-DCAPACITOR_TELEMETRY' (opción 'CAPACITOR_TELEMETRY' de CMake); en otro caso las macros no generan código y los ciclos quedan idénticos.
+//   TELEMETRY_SCOPE(fase)              mide el bloque actual como parte de la fase (barrido, convergencia, halo o reducción). Las fases anidadas excluyen su tiempo de la fase exterior.
+//   TELEMETRY_ITERATION(its, residuo)  cierra la iteración 'its'; el residuo es NAN en las iteraciones sin evaluación de la convergencia.
+//                                      El tiempo de la iteración se mide desde la iteración anterior, por lo que el de la primera incluye la preparación del método.
+//   TELEMETRY_FINISH()                 escribe el resumen de la ejecución.
+// Cada iteración se escribe como una línea JSON en el archivo de 'telemetry_open' ('-' para la salida de error) y/o se entrega a la función de 'telemetry_set_callback':
+//   {"iteracion":12,"residuo":3.1e-05,"t_iteracion":1.2e-03,"t_barrido":1.1e-03,"t_convergencia":0,"t_halo":6e-05,"t_reduccion":4e-05,"ciclos":...,"instrucciones":...,"fallos_cache":...}
+// Los tiempos se miden con 'steady_clock' únicamente en el hilo que abre los bloques, por lo que las fases de las versiones con OpenMP se marcan fuera de las regiones paralelas (o dentro de 'omp master').
+// Con 'contadores' se leen ciclos, instrucciones y fallos del último nivel de caché con 'perf_event_open' para el hilo que llama a 'telemetry_open'; si el sistema no lo permite ('perf_event_paranoid') se omiten.
+
+enum TelemetryPhase{ PHASE_SWEEP, PHASE_CHECK, PHASE_HALO, PHASE_REDUCTION, PHASE_COUNT };
+
+#ifdef CAPACITOR_TELEMETRY
+
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+const int TELEMETRY_COUNTERS = 3;
+
+// Registro de una iteración. Los contadores valen -1 si no están disponibles.
+struct TelemetryRecord{
+  int iteration = 0;
+  double residual = NAN;
+  double total = 0.0;
+  double phase[PHASE_COUNT] = {0.0, 0.0, 0.0, 0.0};
+  long long counters[TELEMETRY_COUNTERS] = {-1, -1, -1};
+};
+
+typedef std::chrono::steady_clock TelemetryClock;
+
+struct TelemetryState{
+  bool enabled = false;
+  std::FILE* file = NULL;
+  std::function<void(const TelemetryRecord&)> callback;
+  // Fase del bloque abierto (PHASE_COUNT fuera de todo bloque) e instante desde el que se le asigna tiempo.
+  int current = PHASE_COUNT;
+  TelemetryClock::time_point mark;
+  TelemetryClock::time_point iteration_start;
+  TelemetryClock::time_point run_start;
+  TelemetryRecord record;
+  double totals[PHASE_COUNT] = {0.0, 0.0, 0.0, 0.0};
+  std::vector<double> residuals;
+  int last_iteration = 0;
+  // Grupo de 'perf_event_open' (el primero es el líder) y su última lectura.
+  int counter_fd[TELEMETRY_COUNTERS] = {-1, -1, -1};
+  long long counter_last[TELEMETRY_COUNTERS] = {0, 0, 0};
+  long long counter_totals[TELEMETRY_COUNTERS] = {0, 0, 0};
+};
+
+inline TelemetryState& telemetry(){
+  static TelemetryState state;
+  return state;
+}
+
+inline const char* phase_name(int phase){
+  static const char* names[PHASE_COUNT] = {"barrido", "convergencia", "halo", "reduccion"};
+  return names[phase];
+}
+
+inline void open_counters(TelemetryState& state){
+  const unsigned long long configs[TELEMETRY_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+  for(int k=0; k < TELEMETRY_COUNTERS; ++k){
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[k];
+    attr.disabled = (k == 0);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, (k == 0) ? -1 : state.counter_fd[0], 0);
+    if(fd < 0){
+      std::cerr << "No se pudieron abrir los contadores de hardware (perf_event_open); se omiten." << std::endl;
+      for(int l=0; l < k; ++l){
+        close(state.counter_fd[l]);
+        state.counter_fd[l] = -1;
+      }
+      return;
+    }
+    state.counter_fd[k] = fd;
+  }
+  ioctl(state.counter_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(state.counter_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+// Lectura del grupo: el número de eventos seguido de un valor por evento.
+inline bool read_counters(const TelemetryState& state, long long values[TELEMETRY_COUNTERS]){
+  if(state.counter_fd[0] < 0){
+    return false;
+  }
+  uint64_t buffer[1 + TELEMETRY_COUNTERS];
+  if(read(state.counter_fd[0], buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer)){
+    return false;
+  }
+  for(int k=0; k < TELEMETRY_COUNTERS; ++k){
+    values[k] = (long long)buffer[1+k];
+  }
+  return true;
+}
+
+// Asigna a la fase abierta el tiempo transcurrido desde la última marca.
+inline void charge(TelemetryState& state, TelemetryClock::time_point now){
+  if(state.current < PHASE_COUNT){
+    state.record.phase[state.current] += std::chrono::duration<double>(now - state.mark).count();
+  }
+  state.mark = now;
+}
+
+// Activa la telemetría. 'path' es el archivo de líneas JSON ('-' para la salida de error, vacío para usar sólo 'telemetry_set_callback').
+// En la versión distribuida cada proceso escribe su propio archivo, con el rango agregado al nombre ('telemetria.jsonl.3').
+inline void telemetry_open(const std::string& path, bool counters, int rank = 0, int size = 1){
+  TelemetryState& state = telemetry();
+  state.enabled = true;
+  if(path == "-"){
+    state.file = stderr;
+  } else if(!path.empty()){
+    std::string name = (size > 1) ? path + "." + std::to_string(rank) : path;
+    state.file = std::fopen(name.c_str(), "w");
+    if(state.file == NULL){
+      std::cerr << "No se pudo crear el archivo de telemetría " << name << "!" << std::endl;
+      exit(1);
+    }
+  }
+  if(counters){
+    open_counters(state);
+  }
+  read_counters(state, state.counter_last);
+  state.run_start = state.iteration_start = state.mark = TelemetryClock::now();
+}
+
+inline void telemetry_set_callback(std::function<void(const TelemetryRecord&)> callback){
+  telemetry().callback = callback;
+}
+
+// Historial del residuo de las iteraciones con evaluación de la convergencia.
+inline const std::vector<double>& telemetry_residuals(){
+  return telemetry().residuals;
+}
+
+inline void write_json_number(std::FILE* file, const char* key, double value){
+  if(std::isnan(value)){
+    std::fprintf(file, ",\"%s\":null", key);
+  } else{
+    std::fprintf(file, ",\"%s\":%.6e", key, value);
+  }
+}
+
+inline void write_counters(std::FILE* file, const TelemetryRecord& record){
+  static const char* counter_names[TELEMETRY_COUNTERS] = {"ciclos", "instrucciones", "fallos_cache"};
+  for(int k=0; k < TELEMETRY_COUNTERS; ++k){
+    if(record.counters[k] >= 0){
+      std::fprintf(file, ",\"%s\":%lld", counter_names[k], record.counters[k]);
+    }
+  }
+}
+
+inline void write_record(std::FILE* file, const TelemetryRecord& record){
+  std::fprintf(file, "{\"iteracion\":%d", record.iteration);
+  write_json_number(file, "residuo", record.residual);
+  write_json_number(file, "t_iteracion", record.total);
+  for(int p=0; p < PHASE_COUNT; ++p){
+    std::string key = std::string("t_") + phase_name(p);
+    write_json_number(file, key.c_str(), record.phase[p]);
+  }
+  write_counters(file, record);
+  std::fprintf(file, "}\n");
+}
+
+// Bloque medido: al abrirse asigna el tiempo previo a la fase exterior y al cerrarse regresa a ella.
+class TelemetryScope{
+public:
+  explicit TelemetryScope(int phase){
+    TelemetryState& state = telemetry();
+    if(!state.enabled){
+      return;
+    }
+    charge(state, TelemetryClock::now());
+    previous_ = state.current;
+    state.current = phase;
+  }
+
+  ~TelemetryScope(){
+    TelemetryState& state = telemetry();
+    if(!state.enabled){
+      return;
+    }
+    charge(state, TelemetryClock::now());
+    state.current = previous_;
+  }
+
+  TelemetryScope(const TelemetryScope&) = delete;
+  TelemetryScope& operator=(const TelemetryScope&) = delete;
+
+private:
+  int previous_ = PHASE_COUNT;
+};
+
+inline void telemetry_iteration(int iteration, double residual){
+  TelemetryState& state = telemetry();
+  if(!state.enabled){
+    return;
+  }
+  TelemetryClock::time_point now = TelemetryClock::now();
+  charge(state, now);
+  TelemetryRecord& record = state.record;
+  record.iteration = iteration;
+  state.last_iteration = iteration;
+  record.residual = residual;
+  record.total = std::chrono::duration<double>(now - state.iteration_start).count();
+  long long values[TELEMETRY_COUNTERS];
+  if(read_counters(state, values)){
+    for(int k=0; k < TELEMETRY_COUNTERS; ++k){
+      record.counters[k] = values[k] - state.counter_last[k];
+      state.counter_totals[k] += record.counters[k];
+      state.counter_last[k] = values[k];
+    }
+  }
+  for(int p=0; p < PHASE_COUNT; ++p){
+    state.totals[p] += record.phase[p];
+  }
+  if(!std::isnan(residual)){
+    state.residuals.push_back(residual);
+  }
+  if(state.file != NULL){
+    write_record(state.file, record);
+  }
+  if(state.callback){
+    state.callback(record);
+  }
+  state.record = TelemetryRecord();
+  state.iteration_start = TelemetryClock::now();
+  state.mark = state.iteration_start;
+}
+
+// Resumen de la ejecución ('"resumen":true') con los tiempos y contadores acumulados, y cierre del archivo.
+inline void telemetry_finish(){
+  TelemetryState& state = telemetry();
+  if(!state.enabled){
+    return;
+  }
+  if(state.file != NULL){
+    TelemetryRecord summary;
+    summary.iteration = (int)state.residuals.size();
+    summary.residual = state.residuals.empty() ? NAN : state.residuals.back();
+    summary.total = std::chrono::duration<double>(TelemetryClock::now() - state.run_start).count();
+    for(int p=0; p < PHASE_COUNT; ++p){
+      summary.phase[p] = state.totals[p];
+    }
+    for(int k=0; k < TELEMETRY_COUNTERS; ++k){
+      summary.counters[k] = (state.counter_fd[0] >= 0) ? state.counter_totals[k] : -1;
+    }
+    std::fprintf(state.file, "{\"resumen\":true,\"iteraciones\":%d,\"evaluaciones\":%d", state.last_iteration, summary.iteration);
+    write_json_number(state.file, "residuo", summary.residual);
+    write_json_number(state.file, "t_total", summary.total);
+    for(int p=0; p < PHASE_COUNT; ++p){
+      std::string key = std::string("t_") + phase_name(p);
+      write_json_number(state.file, key.c_str(), summary.phase[p]);
+    }
+    write_counters(state.file, summary);
+    std::fprintf(state.file, "}\n");
+    if(state.file != stderr){
+      std::fclose(state.file);
+    } else{
+      std::fflush(state.file);
+    }
+    state.file = NULL;
+  }
+  for(int k=0; k < TELEMETRY_COUNTERS; ++k){
+    if(state.counter_fd[k] >= 0){
+      close(state.counter_fd[k]);
+      state.counter_fd[k] = -1;
+    }
+  }
+  state.enabled = false;
+}
+
+#define TELEMETRY_CONCAT_(a, b) a##b
+#define TELEMETRY_CONCAT(a, b) TELEMETRY_CONCAT_(a, b)
+#define TELEMETRY_SCOPE(phase) TelemetryScope TELEMETRY_CONCAT(telemetry_scope_, __LINE__)(phase)
+#define TELEMETRY_ITERATION(iteration, residual) telemetry_iteration((iteration), (residual))
+#define TELEMETRY_FINISH() telemetry_finish()
+
+#else
+
+// Sin telemetría compilada, la opción de la línea de comandos termina la ejecución en lugar de ignorarse.
+inline void telemetry_open(const std::string&, bool, int = 0, int = 1){
+  std::cerr << "El ejecutable se compiló sin telemetría; se debe compilar con '-DCAPACITOR_TELEMETRY'!" << std::endl;
+  exit(1);
+}
+
+#define TELEMETRY_SCOPE(phase) ((void)0)
+#define TELEMETRY_ITERATION(iteration, residual) ((void)0)
+#define TELEMETRY_FINISH() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef TEMPORAL_BLOCKING_H
+#define TEMPORAL_BLOCKING_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include "stencil_kernel.h"
+
+// Bloqueo temporal de las iteraciones rojo-negro de 'stencil_kernel.h'.
+// Un barrido simple lee y escribe la grilla completa en cada media iteración, por lo que en grillas que no caben en caché cada iteración cuesta dos pasadas por memoria.
+// Con profundidad 'depth' se aplican 'depth' iteraciones consecutivas (K = 2*depth medias iteraciones) a un bloque de filas antes de pasar al siguiente:
+//   - El bloque b inicia en la fila r0 = 1 + b*blockRows. La media iteración k (color k%2) recorre las filas [r0 - k, r0 + blockRows - k), recortadas al interior [1, rows-1).
+//   - Este corrimiento (esquema sesgado) garantiza que cada fila se actualiza con los vecinos del paso anterior, igual que en el barrido simple: el resultado es idéntico bit a bit.
+//   - Las filas del bloque permanecen en caché durante los K pasos, así que la grilla se recorre en memoria una vez cada 'depth' iteraciones.
+// La diferencia máxima que se regresa es la de la última iteración (las dos últimas medias iteraciones), como en el barrido simple.
+
+// Presupuesto de caché para las filas de un bloque: del orden de la caché L2 de un núcleo.
+const std::size_t TEMPORAL_CACHE_BYTES = 512*1024;
+
+// Filas por bloque para que las filas que toca un bloque (el bloque, el corrimiento de 2*depth filas y los vecinos) quepan en 'cache_bytes'.
+template<typename Real = double>
+inline int temporal_block_rows(int stride, int depth, std::size_t cache_bytes = TEMPORAL_CACHE_BYTES){
+  long rows = (long)(cache_bytes/(stride*sizeof(Real))) - 2*depth - 2;
+  return (int)std::max(rows, 4L);
+}
+
+inline void check_temporal_depth(int depth, int blockRows){
+  if(depth < 1){
+    std::cerr << "La profundidad del bloque temporal debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+  }
+  if(blockRows < 2){
+    std::cerr << "El bloque temporal debe tener al menos dos filas!" << std::endl;
+    exit(1);
+  }
+}
+
+// Filas [begin, end) de la media iteración 'step' del bloque 'block'; el intervalo es vacío si el bloque ya salió del interior.
+inline void temporal_rows(int rows, int blockRows, int block, int step, int& begin, int& end){
+  int r0 = 1 + block*blockRows;
+  begin = std::max(1, r0 - step);
+  end = std::min(rows - 1, r0 + blockRows - step);
+}
+
+// Número de bloques necesario para que la última media iteración llegue hasta la fila rows-2.
+inline int temporal_blocks(int rows, int blockRows, int depth){
+  return (rows - 2 + 2*depth - 1 + blockRows - 1)/blockRows;
+}
+
+// Versión serial: cada bloque recibe sus K medias iteraciones antes de pasar al siguiente.
+template<typename Real>
+inline Real temporal_sweeps(const BasicStencilKernel<Real>& stencil, Real* phi, const unsigned char* mask, int stride, int rows, int depth, int blockRows, Real omega){
+  check_temporal_depth(depth, blockRows);
+  int steps = 2*depth;
+  int blocks = temporal_blocks(rows, blockRows, depth);
+  Real maxDelta = 0;
+  for(int b=0; b < blocks; ++b){
+    for(int k=0; k < steps; ++k){
+      int begin, end;
+      temporal_rows(rows, blockRows, b, k, begin, end);
+      if(begin >= end){
+        continue;
+      }
+      Real delta = stencil.sweep(phi, mask, stride, begin, end, 0, k % 2, omega);
+      if(k >= steps - 2){
+        maxDelta = std::max(maxDelta, delta);
+      }
+    }
+  }
+  return maxDelta;
+}
+
+// Versión con OpenMP: frente de onda de bloques (pipeline). En la fase p el hilo que toma el paso k procesa el bloque p-k.
+// Los pasos de una misma fase tocan filas separadas al menos por un bloque, así que pueden ejecutarse a la vez; la barrera implícita de 'omp for' separa las fases.
+// El paralelismo está limitado a K = 2*depth hilos. Cada bloque pasa de un hilo al siguiente entre fases, por lo que las filas de los K bloques en curso deben caber en la suma de las cachés de esos hilos:
+// con 'temporal_block_rows' cada bloque ocupa el presupuesto de un núcleo.
+// Debe llamarse fuera de una región paralela. Sin OpenMP se ejecuta en el mismo orden de fases, que también es válido.
+template<typename Real>
+inline Real temporal_sweeps_pipelined(const BasicStencilKernel<Real>& stencil, Real* phi, const unsigned char* mask, int stride, int rows, int depth, int blockRows, Real omega){
+  check_temporal_depth(depth, blockRows);
+  int steps = 2*depth;
+  int blocks = temporal_blocks(rows, blockRows, depth);
+  Real maxDelta = 0;
+  #pragma omp parallel
+  for(int p=0; p < blocks + steps - 1; ++p){
+    #pragma omp for schedule(static, 1) reduction(max:maxDelta)
+    for(int k=0; k < steps; ++k){
+      int b = p - k;
+      if(b < 0 || b >= blocks){
+        continue;
+      }
+      int begin, end;
+      temporal_rows(rows, blockRows, b, k, begin, end);
+      if(begin >= end){
+        continue;
+      }
+      Real delta = stencil.sweep(phi, mask, stride, begin, end, 0, k % 2, omega);
+      if(k >= steps - 2){
+        maxDelta = std::max(maxDelta, delta);
+      }
+    }
+  }
+  return maxDelta;
+}
+
+#endif
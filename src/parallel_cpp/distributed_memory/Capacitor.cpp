@@ -1,9 +1,244 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
 #include <mpi.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "grid2d.h"
+#include "symmetry.h"
+#include "omega_tuning.h"
+#include "checkpoint.h"
+#include "telemetry.h"
 
-void gauss_seidel(double V1, double V2, double omega, int factor, double tolerance){
+// Opciones de ejecución comunes a todas las variantes del método.
+struct RunOptions{
+  // Reporte del tiempo de espera en comunicación de cada proceso (ver 'report_waits').
+  bool waits = false;
+  // Archivo de salida binaria (ver 'write_binary'); vacío para imprimir la grilla.
+  std::string output = "";
+  // Modo de medición: en lugar de la grilla se imprime únicamente la cantidad de iteraciones.
+  bool benchmark = false;
+  // Reserva de la grilla local de la versión híbrida con páginas grandes (ver 'grid2d.h').
+  bool huge_pages = false;
+  // Puntos de control, reanudación y valor inicial interpolado (ver 'load_strip_state' y 'save_strip_checkpoint').
+  CheckpointSettings checkpoint;
+  // Archivo de telemetría por iteración y contadores de hardware (ver 'start_telemetry').
+  std::string telemetry = "";
+  bool counters = false;
+  // Dominio reducido por simetría de la versión híbrida: 'ninguna', 'mitad', 'cuarto' o 'auto' (ver 'symmetry.h').
+  std::string symmetry = "ninguna";
+};
+
+// Con '--omega auto' el proceso 0 obtiene el omega óptimo (desde 'omega_cache.dat' o estimándolo, ver 'omega_tuning.h') y lo distribuye a los demás procesos.
+// Se llama justo después de inicializar MPI, antes de iniciar la medición del tiempo.
+// La estimación supone un ordenamiento consistente (rojo-negro, o lexicográfico con un único proceso); en el recorrido lexicográfico por filas con varios procesos las filas fantasma se actualizan con una iteración de retraso y el omega estimado puede resultar excesivo.
+void resolve_omega(double& omega, int factor, bool consistent, MPI_Comm comm){
+  if(omega != AUTO_OMEGA){
+    return;
+  }
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  if(rank == 0){
+    omega = auto_omega(factor);
+    if(!consistent && size > 1){
+      std::cerr << "ADVERTENCIA: el omega automático supone un ordenamiento consistente; con el recorrido lexicográfico y varios procesos se recomienda '--kernel' o '--cartesiano'." << std::endl;
+    }
+  }
+  MPI_Bcast(&omega, 1, MPI_DOUBLE, 0, comm);
+}
+
+// Con '--telemetria' cada proceso escribe su propia telemetría por iteración ('telemetry.h'), con el rango agregado al nombre del archivo.
+// Las fases de halo y reducción corresponden a los mismos intervalos que 'report_waits', por lo que su suma por proceso coincide con la de '--esperas'.
+// Se llama junto con 'resolve_omega', antes de iniciar la medición del tiempo.
+void start_telemetry(const RunOptions& options, MPI_Comm comm){
+  if(options.telemetry.empty()){
+    return;
+  }
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  telemetry_open(options.telemetry, options.counters, rank, size);
+}
+
+// Reporte del tiempo que cada proceso permanece bloqueado en comunicación: intercambio de filas fantasma ('halo') y reducción del delta (incluyendo barreras).
+// El proceso 0 recolecta los tiempos y los imprime en la salida de error, para no alterar la grilla impresa en la salida estándar.
+void report_waits(double halo, double reduction, int rank, int size, MPI_Comm comm){
+  double local[2] = {halo, reduction};
+  std::vector<double> waits(2*size);
+  MPI_Gather(local, 2, MPI_DOUBLE, waits.data(), 2, MPI_DOUBLE, 0, comm);
+  if(rank == 0){
+    for(int r=0; r < size; ++r){
+      std::cerr << "Proceso: " << r << "; Espera de filas fantasma: " << waits[2*r] << "; Espera de reducción: " << waits[2*r+1] << "; Espera total: " << waits[2*r] + waits[2*r+1] << std::endl;
+    }
+  }
+}
+
+// Salida binaria de la grilla con MPI-IO.
+// El archivo inicia con un encabezado de 64 bytes, seguido de las 'rows'x'columns' entradas de la grilla como dobles little-endian en orden por filas:
+//   bytes 0-7:   identificador "CAPGRID1"
+//   bytes 8-23:  filas, columnas, factor de escala e iteraciones (enteros de 32 bits)
+//   bytes 24-47: V1, V2 y omega (dobles)
+//   bytes 48-55: tolerancia (cero, no se registra en esta versión)
+//   bytes 56-63: reservados (ceros)
+// Cada proceso escribe su bloque (sin celdas fantasma) en la posición que le corresponde con una escritura colectiva ('MPI_File_write_at_all'); el bloque inicia en 'block', tiene 'nrows'x'ncols' entradas con ancho de fila 'ld' y se ubica en la fila 'rowStart' y columna 'colStart' de la grilla.
+// El encabezado es el de 'checkpoint.h', por lo que el archivo sirve también como punto de control y como valor inicial de los demás solucionadores.
+const int OUTPUT_HEADER_BYTES = GRID_HEADER_BYTES;
+
+void write_binary(const std::string& path, const double* block, int ld, int rowStart, int nrows, int colStart, int ncols, int factor, double V1, double V2, double omega, int its, MPI_Comm comm){
+  if(__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__){
+    std::cerr << "La salida binaria sólo está disponible en arquitecturas little-endian!" << std::endl;
+    MPI_Abort(comm, 1);
+  }
+
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  int rows = 10*factor;
+  int columns = 10*factor+1;
+
+  MPI_File file;
+  if(MPI_File_open(comm, path.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS){
+    std::cerr << "No se pudo abrir el archivo de salida: " << path << std::endl;
+    MPI_Abort(comm, 1);
+  }
+  MPI_File_set_size(file, 0);
+
+  if(rank == 0){
+    GridHeader header;
+    header.rows = rows;
+    header.columns = columns;
+    header.factor = factor;
+    header.iterations = its;
+    header.V1 = V1;
+    header.V2 = V2;
+    header.omega = omega;
+    char bytes[OUTPUT_HEADER_BYTES];
+    encode_header(header, bytes);
+    MPI_File_write_at(file, 0, bytes, OUTPUT_HEADER_BYTES, MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+
+  // La vista del archivo selecciona el bloque del proceso dentro de la grilla global; el tipo en memoria omite las celdas fantasma.
+  int sizes[2] = {rows, columns};
+  int subsizes[2] = {nrows, ncols};
+  int starts[2] = {rowStart, colStart};
+  MPI_Datatype file_type, memory_type;
+  MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &file_type);
+  MPI_Type_commit(&file_type);
+  MPI_Type_vector(nrows, ncols, ld, MPI_DOUBLE, &memory_type);
+  MPI_Type_commit(&memory_type);
+
+  MPI_File_set_view(file, OUTPUT_HEADER_BYTES, MPI_DOUBLE, file_type, "native", MPI_INFO_NULL);
+  MPI_File_write_at_all(file, 0, block, 1, memory_type, MPI_STATUS_IGNORE);
+  MPI_File_close(&file);
+
+  MPI_Type_free(&file_type);
+  MPI_Type_free(&memory_type);
+}
+
+// Lectura colectiva de un archivo de 'write_binary' (por ejemplo, un punto de control), con la misma vista por bloques: cada proceso lee únicamente su bloque con 'MPI_File_read_at_all'.
+// Regresa falso si el archivo no existe; si corresponde a otro factor de escala se aborta la ejecución. 'its' recibe las iteraciones del encabezado.
+bool read_binary(const std::string& path, double* block, int ld, int rowStart, int nrows, int colStart, int ncols, int factor, int& its, MPI_Comm comm){
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  int rows = 10*factor;
+  int columns = 10*factor+1;
+
+  MPI_File file;
+  if(MPI_File_open(comm, path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS){
+    return false;
+  }
+
+  // El proceso 0 valida el encabezado y distribuye las iteraciones (-1 si el archivo no es válido).
+  int header_its = -1;
+  if(rank == 0){
+    char bytes[OUTPUT_HEADER_BYTES];
+    GridHeader header;
+    MPI_File_read_at(file, 0, bytes, OUTPUT_HEADER_BYTES, MPI_BYTE, MPI_STATUS_IGNORE);
+    if(!decode_header(bytes, header) || header.factor != factor){
+      std::cerr << "El archivo " << path << " no es una grilla del factor " << factor << "!" << std::endl;
+    } else{
+      header_its = header.iterations;
+    }
+  }
+  MPI_Bcast(&header_its, 1, MPI_INT, 0, comm);
+  if(header_its < 0){
+    MPI_Abort(comm, 1);
+  }
+  its = header_its;
+
+  int sizes[2] = {rows, columns};
+  int subsizes[2] = {nrows, ncols};
+  int starts[2] = {rowStart, colStart};
+  MPI_Datatype file_type, memory_type;
+  MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &file_type);
+  MPI_Type_commit(&file_type);
+  MPI_Type_vector(nrows, ncols, ld, MPI_DOUBLE, &memory_type);
+  MPI_Type_commit(&memory_type);
+
+  MPI_File_set_view(file, OUTPUT_HEADER_BYTES, MPI_DOUBLE, file_type, "native", MPI_INFO_NULL);
+  MPI_File_read_at_all(file, 0, block, 1, memory_type, MPI_STATUS_IGNORE);
+  MPI_File_close(&file);
+
+  MPI_Type_free(&file_type);
+  MPI_Type_free(&memory_type);
+  return true;
+}
+
+// Estado inicial de la franja de filas completas [rowStart, rowStart+nrows) de cada proceso, que inicia en 'block' con filas separadas por 'ld' entradas.
+// Si se reanuda y el punto de control existe, se lee colectivamente con 'read_binary'; de lo contrario, con un valor inicial cada proceso interpola sus filas desde la grilla de otro factor ('interpolate_rows').
+// Regresa las iteraciones previas, que también se guardan en 'settings.start'.
+int load_strip_state(CheckpointSettings& settings, double* block, int ld, int rowStart, int nrows, int factor, double V1, double V2, MPI_Comm comm){
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  int column = 10*factor+1;
+  settings.start = 0;
+  if(settings.resume && read_binary(settings.path, block, ld, rowStart, nrows, 0, column, factor, settings.start, comm)){
+    if(rank == 0){
+      std::cerr << "Reanudando desde " << settings.path << " con " << settings.start << " iteraciones previas" << std::endl;
+    }
+  } else if(!settings.initial.empty()){
+    GridHeader header;
+    std::vector<double> data;
+    if(!read_grid_file(settings.initial, header, data)){
+      std::cerr << "No se pudo abrir el archivo inicial: " << settings.initial << std::endl;
+      MPI_Abort(comm, 1);
+    }
+    std::vector<double> rows = interpolate_rows(header, data, factor, rowStart, rowStart+nrows, V1, V2);
+    for(int i = 0; i < nrows; ++i){
+      std::copy(rows.begin() + (size_t)i*column, rows.begin() + (size_t)(i+1)*column, block + (size_t)i*ld);
+    }
+    if(rank == 0){
+      std::cerr << "Valor inicial interpolado desde " << settings.initial << " (factor " << header.factor << ")" << std::endl;
+    }
+  }
+  return settings.start;
+}
+
+// Punto de control colectivo de las franjas después de la iteración 'its' (cada 'settings.every' iteraciones, o siempre con 'final').
+// Todos los procesos escriben 'path.tmp' con 'write_binary' y el proceso 0 lo renombra al cerrarse el archivo, de forma que una ejecución interrumpida nunca deja un punto de control incompleto.
+void save_strip_checkpoint(const CheckpointSettings& settings, const double* block, int ld, int rowStart, int nrows, int factor, double V1, double V2, double omega, int its, MPI_Comm comm, bool final = false){
+  if(settings.path.empty() || (!final && its % settings.every != 0)){
+    return;
+  }
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  int column = 10*factor+1;
+  std::string temporary = settings.path + ".tmp";
+  write_binary(temporary, block, ld, rowStart, nrows, 0, column, factor, V1, V2, omega, its, comm);
+  if(rank == 0 && std::rename(temporary.c_str(), settings.path.c_str()) != 0){
+    std::cerr << "Error al escribir el punto de control: " << settings.path << std::endl;
+    MPI_Abort(comm, 1);
+  }
+}
+
+// El argumento 'kernel' permite reemplazar el recorrido lexicográfico de Gauss-Seidel por iteraciones rojo-negro con el kernel vectorizado de 'stencil_kernel.h' ('auto', 'avx512', 'avx2' o 'scalar'). Con el valor por defecto (vacío) se emplea el recorrido lexicográfico.
+// 'options' controla el reporte de esperas, la salida binaria, los puntos de control y el modo de medición (ver 'RunOptions').
+void gauss_seidel(double V1, double V2, double omega, int factor, double tolerance, const std::string& kernel = "", const RunOptions& options = RunOptions()){
 
   if(tolerance <= 0){
     std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
@@ -19,8 +254,11 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
 
   int size, rank;
   int row = 10*factor;
-  double time_1 = MPI_Wtime();
   MPI_Init(NULL, NULL);
+  resolve_omega(omega, factor, !kernel.empty(), MPI_COMM_WORLD);
+  start_telemetry(options, MPI_COMM_WORLD);
+  // El tiempo se mide desde la inicialización de MPI, igual que en las demás variantes.
+  double time_1 = MPI_Wtime();
   MPI_Comm_size(MPI_COMM_WORLD, &size);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
@@ -49,20 +287,20 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
     end = nlocal-1;
   }
 
-  std::vector<double> local_section;
-
   // IMPORTANTE: Celdas fantasma.
   // Se asigna una fila fantasma al primer y último proceso.
   // Se asginan dos filas fantasma (superior e inferior) a los procesos intermedios.
+  int local_rows = nlocal;
   if(size > 1){
     if(rank == 0 || rank == size - 1){
-      local_section.resize((nlocal+1)*column, 0.0); // MUY IMPORTANTE: GRILLAS FANTASMA
+      local_rows = nlocal+1; // MUY IMPORTANTE: GRILLAS FANTASMA
     } else{
-      local_section.resize((nlocal+2)*column, 0.0);
+      local_rows = nlocal+2;
     }
-  } else{
-    local_section.resize(nlocal*column, 0.0);
   }
+  // La grilla local es la grilla rellena de 'grid2d.h', con filas alineadas de ancho 'ld'; las filas fantasma se intercambian sin el relleno.
+  Grid2D<double> local_section(local_rows, column);
+  int ld = local_section.stride();
 
   // Establecer las condiciones de frontera.
   // Es necesario considerar la posición absoluta de cada entrada, por lo que es necesario un ajuste para contrarrestar el desplazamiento de las filas por la incorporación de filas fantasma.
@@ -73,13 +311,19 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
     }
     for(int j=1; j < column-1; ++j){
       if ((2*factor <= absolute_position && absolute_position < 8*factor) && (j == 2*factor)){
-        local_section[i*column + j] = V1;
+        local_section(i, j) = V1;
       }
       if ((2*factor <= absolute_position && absolute_position < 8*factor) && (j== 8*factor)){
-        local_section[i*column + j] = V2;
+        local_section(i, j) = V2;
       }
     }
   }
+
+  // Las filas propias de cada proceso inician en la fila local 'first' (el proceso 0 no tiene fila fantasma superior).
+  // Al reanudar o con un valor inicial se reemplazan antes del primer intercambio, por lo que las filas fantasma se completan con el estado leído.
+  int first = (rank == 0) ? 0 : 1;
+  CheckpointSettings checkpoint = options.checkpoint;
+  its = load_strip_state(checkpoint, local_section.row(first), ld, start, nlocal, factor, V1, V2, MPI_COMM_WORLD);
    
   // En caso de evaluarse el código con un sólo proceso, no se necesita intercomunicación para filas fantasma.
   // Por lo tanto, esta sección se ejecutará únicamente para dos o más procesos.
@@ -92,20 +336,20 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
     if(rank > 0){
       // Todos los procesos, exceptuando el primero, envían su segunda fila (omitiendo la fila fantasma) al proceso anterior.
       // A su vez, reciben una fila del proceso anterior, almacenándola en la fila fantasma superior. 
-      MPI_Isend(&local_section[column], column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[0]);
-      MPI_Irecv(&local_section[0], column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[1]);
+      MPI_Isend(local_section.row(1), column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[0]);
+      MPI_Irecv(local_section.row(0), column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[1]);
     }
 
     // Transferencia de las filas fantasma inferiores.
     if(rank == 0){
       // El primer proceso envía la penúltima fila al siguiente proceso.
       // A su vez, recibe una fila del siguiente proceso, almacenándola en la fila fantasma.
-      MPI_Isend(&local_section[(nlocal-1)*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
-      MPI_Irecv(&local_section[nlocal*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
+      MPI_Isend(local_section.row(nlocal-1), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
+      MPI_Irecv(local_section.row(nlocal), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
     } else if(rank < size - 1 && rank > 0){
       // Las filas intermedias repiten el proceso anterior, realizando un ajuste para 'nlocal'.
-      MPI_Isend(&local_section[nlocal*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
-      MPI_Irecv(&local_section[(nlocal+1)*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
+      MPI_Isend(local_section.row(nlocal), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
+      MPI_Irecv(local_section.row(nlocal+1), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
     }
 
     // Esperar a que se completen las transferencias de las filas fantasma superiores.
@@ -125,8 +369,62 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
   // Finaliza la intercomunicación de procesos.
   }
 
+  // Intercambio de las filas fantasma con los procesos vecinos, con el mismo proceso anterior al ciclo.
+  auto exchange_ghosts = [&](){
+    if(size > 1){
+      MPI_Request request[4];
+      if(rank > 0){
+        MPI_Isend(local_section.row(1), column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[0]);
+        MPI_Irecv(local_section.row(0), column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[1]);
+      }
+
+      if(rank == 0){
+        MPI_Isend(local_section.row(nlocal-1), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
+        MPI_Irecv(local_section.row(nlocal), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
+      } else if(rank < size - 1 && rank > 0){
+        MPI_Isend(local_section.row(nlocal), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
+        MPI_Irecv(local_section.row(nlocal+1), column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
+      }
+
+      if(rank > 0){
+        MPI_Wait(&request[0], MPI_STATUS_IGNORE);
+        MPI_Wait(&request[1], MPI_STATUS_IGNORE);
+      }
+
+      if(rank < size - 1){
+        MPI_Wait(&request[2], MPI_STATUS_IGNORE);
+        MPI_Wait(&request[3], MPI_STATUS_IGNORE);
+      }
+    }
+  };
+
+  // Para el kernel vectorizado se precalcula la máscara de las entradas que se actualizan en la grilla local.
+  StencilKernel stencil;
+  std::vector<unsigned char> mask;
+  int rowOffset = (rank == 0) ? start : start-1;
+  double halo_wait = 0.0;
+  double reduction_wait = 0.0;
+  double wait_start;
+  if(!kernel.empty()){
+    stencil = select_kernel(kernel);
+    mask = capacitor_mask(local_rows, column, ld, factor, rowOffset);
+  }
+
   while(delta > tolerance){
 
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    if(!kernel.empty()){
+      // Media iteración roja, intercambio de filas fantasma y media iteración negra. El color de cada entrada depende de su fila absoluta.
+      local_maxDelta = stencil.sweep(local_section.data(), mask.data(), ld, 1, end, rowOffset, 0, omega);
+      {
+      TELEMETRY_SCOPE(PHASE_HALO);
+      wait_start = MPI_Wtime();
+      exchange_ghosts();
+      halo_wait += MPI_Wtime() - wait_start;
+      }
+      local_maxDelta = std::max(local_maxDelta, stencil.sweep(local_section.data(), mask.data(), ld, 1, end, rowOffset, 1, omega));
+    } else{
     for(int i=1; i < end; ++i){
       int absolute_position = start+i-1;
       if (rank == 0){
@@ -144,77 +442,86 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
 	  // Cálculo del nuevo valor que recibirá la celda.
 	  // Se define 'new_value' para almacenar temporalmente el valor calculado con la iteración de Gauss-Seidel.
 	  // Esta estrategia permite desarrollar la metodología de Gauss-Seidel sin necesitar una copia de la grilla local.
-	  new_value = ((1.0+omega)*0.25)*(local_section[(i+1)*column + j] + local_section[(i-1)*column + j] + local_section[i*column + (j+1)] + local_section[i*column + (j-1)]) - omega*local_section[i*column + j];
+	  new_value = ((1.0+omega)*0.25)*(local_section(i+1, j) + local_section(i-1, j) + local_section(i, j+1) + local_section(i, j-1)) - omega*local_section(i, j);
 	  // Se compara la diferencia entre el nuevo valor calculado y el valor de la celda con el 'local_maxDelta'.
 	  // En caso de que la diferencia sea mayor a la almacenada en 'local_maxDelta', se actualiza el valor máximo.
-	  local_maxDelta = std::max(local_maxDelta, std::abs(local_section[i*column + j] - new_value));
+	  local_maxDelta = std::max(local_maxDelta, std::abs(local_section(i, j) - new_value));
 	  // Finalmente, se asigna el valor calculado a la entrada correspondiente.
-	  local_section[i*column + j] = new_value;
+	  local_section(i, j) = new_value;
         }
       }
     }
+    }
+    }
 
+    {
+    TELEMETRY_SCOPE(PHASE_REDUCTION);
+    wait_start = MPI_Wtime();
     MPI_Barrier(MPI_COMM_WORLD);
+    reduction_wait += MPI_Wtime() - wait_start;
+    }
 
     // Sumamos una iteración al contador.
     its++;
     // Volvemos a intercomunicar las filas fantasma, con el mismo proceso anterior al ciclo.
-    if(size > 1){
-      MPI_Request request[4];
-      if(rank > 0){
-        MPI_Isend(&local_section[column], column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[0]);
-        MPI_Irecv(&local_section[0], column, MPI_DOUBLE, rank-1, 0, MPI_COMM_WORLD, &request[1]);
-      }
-
-      if(rank == 0){
-        MPI_Isend(&local_section[(nlocal-1)*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
-        MPI_Irecv(&local_section[nlocal*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
-      } else if(rank < size - 1 && rank > 0){
-        MPI_Isend(&local_section[nlocal*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[2]);
-        MPI_Irecv(&local_section[(nlocal+1)*column], column, MPI_DOUBLE, rank+1, 0, MPI_COMM_WORLD, &request[3]);
-      }
-
-      if(rank > 0){
-        MPI_Wait(&request[0], MPI_STATUS_IGNORE);
-        MPI_Wait(&request[1], MPI_STATUS_IGNORE);
-      }
-
-      if(rank < size - 1){
-        MPI_Wait(&request[2], MPI_STATUS_IGNORE);
-        MPI_Wait(&request[3], MPI_STATUS_IGNORE);
-      }
+    {
+    TELEMETRY_SCOPE(PHASE_HALO);
+    wait_start = MPI_Wtime();
+    exchange_ghosts();
+    halo_wait += MPI_Wtime() - wait_start;
     }
 
     // Comunicar el delta.
     double global_delta = 0.0;
+    {
+    TELEMETRY_SCOPE(PHASE_REDUCTION);
+    wait_start = MPI_Wtime();
     MPI_Allreduce(&local_maxDelta, &global_delta, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    reduction_wait += MPI_Wtime() - wait_start;
+    }
     delta = global_delta;
+    TELEMETRY_ITERATION(its, delta);
 
     if (delta > 1e10) {
       std::cerr << "WARNING: Delta is increasing uncontrollably, consider changing omega value." << std::endl;
       break;
     }
 
-  
+    save_strip_checkpoint(checkpoint, local_section.row(first), ld, start, nlocal, factor, V1, V2, omega, its, MPI_COMM_WORLD);
   }
+  save_strip_checkpoint(checkpoint, local_section.row(first), ld, start, nlocal, factor, V1, V2, omega, its, MPI_COMM_WORLD, true);
   // Una vez finalizadas las iteraciones, se detiene el conteo de tiempo.
   // Considerar el tiempo que se dure imprimiendo sesgaría la verdadera evaluación de la escalabilidad de las iteraciones.
   double time_2 = MPI_Wtime();
+  TELEMETRY_FINISH();
 
   // Imprimir la matriz resultante.
   MPI_Request print_request;
   int signal = 1;
 
+  if(options.benchmark){
+    if(rank == 0){
+      std::cout << "Número de procesos: " << size << std::endl;
+      std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+      std::cout << "Iteraciones: " << its << std::endl;
+    }
+  // Con salida binaria todos los procesos escriben simultáneamente su franja, omitiendo las filas fantasma.
+  } else if(!options.output.empty()){
+    if(rank == 0){
+      std::cout << "Número de procesos: " << size << std::endl;
+      std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+    }
+    write_binary(options.output, local_section.row(first), ld, start, nlocal, 0, column, factor, V1, V2, omega, its, MPI_COMM_WORLD);
   // Si el código se ejecuta con únicamente un proceso, simplemente se imprime la matriz.
-  if(size == 1){ 
+  } else if(size == 1){ 
     std::cout << "Número de procesos: " << size << std::endl;
     std::cout << "Tiémpo transcurrido: " << time_2 - time_1 << std::endl;
     for(int i = 0; i < row; i++){
       for(int j = 0; j < column; j++){
 	if(j < column - 1){
-        std::cout << local_section[i*column+j] << ";";
+        std::cout << local_section(i, j) << ";";
 	} else{
-	  std::cout << local_section[i*column+j] << std::endl;
+	  std::cout << local_section(i, j) << std::endl;
 	}
       }
     }
@@ -230,9 +537,9 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
       for(int i = 0; i < end; i++){
         for(int j = 0; j < column; j++){
 	  if(j < column - 1){
-	    std::cout << local_section[i*column+j] << ";";
+	    std::cout << local_section(i, j) << ";";
 	  } else{
-	    std::cout << local_section[i*column+j] << std::endl;
+	    std::cout << local_section(i, j) << std::endl;
 	  }
         }
       }
@@ -252,9 +559,9 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
         for(int i = 1; i < end; i++){
           for(int j = 0; j < column; j++){
             if(j < column - 1){
-              std::cout << local_section[i*column+j] << ";";
+              std::cout << local_section(i, j) << ";";
             } else{
-              std::cout << local_section[i*column+j] << std::endl;
+              std::cout << local_section(i, j) << std::endl;
             }
           }
         }
@@ -268,9 +575,9 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
         for(int i = 1; i < end+1; i++){
           for(int j = 0; j < column; j++){
 	    if(j < column-1){
-	      std::cout << local_section[i*column+j] << ";";
+	      std::cout << local_section(i, j) << ";";
 	    } else{
-	      std::cout << local_section[i*column+j] << std::endl;
+	      std::cout << local_section(i, j) << std::endl;
 	    }
 	  }
         }
@@ -278,18 +585,974 @@ void gauss_seidel(double V1, double V2, double omega, int factor, double toleran
     }
   }
 
+  if(options.waits){
+    report_waits(halo_wait, reduction_wait, rank, size, MPI_COMM_WORLD);
+  }
+
   // Establecemos una barrera para asegurar que todos los procesos hayan finalizado antes de cerrar el ambiente MPI.
   MPI_Barrier(MPI_COMM_WORLD);
   // Finalización del ambiente MPI.
   MPI_Finalize();
 }
 
-int main(){
+// Reparto de 'n' entradas entre 'parts' procesos, con el mismo criterio de 'nlocal' y 'rest' de la descomposición por filas.
+// Regresa la primera entrada ('start') y la cantidad de entradas ('count') asignadas a la coordenada 'coord'.
+void block_range(int n, int parts, int coord, int& start, int& count){
+  count = n/parts;
+  int rest = n%parts;
+  start = count*coord + std::min(coord, rest);
+  if(coord < rest){
+    count++;
+  }
+}
+
+// Recolección en el proceso 0 de las filas propias de cada franja ('MPI_Gatherv'); los demás procesos reciben una grilla vacía.
+// Cada franja es una grilla rellena ('Grid2D') con una fila fantasma arriba; sus filas se envían sin el relleno con un tipo 'MPI_Type_vector'.
+// Con 'symmetry' las franjas corresponden al dominio reducido y se regresa la grilla completa reconstruida con 'expand_grid'.
+std::vector<double> gather_strips(const Grid2D<double>& local_section, int nlocal, int factor, MPI_Comm comm, const SymmetryDomain& symmetry = SymmetryDomain()){
+  int size, rank;
+  MPI_Comm_size(comm, &size);
+  MPI_Comm_rank(comm, &rank);
+  bool reduced = (symmetry.mode != SYMMETRY_NONE);
+  int row = reduced ? symmetry.rows : 10*factor;
+  int column = reduced ? symmetry.columns : 10*factor+1;
+
+  std::vector<int> counts(size), displs(size);
+  for(int r=0; r < size; ++r){
+    int rs, nr;
+    block_range(row, size, r, rs, nr);
+    counts[r] = nr*column;
+    displs[r] = rs*column;
+  }
+  std::vector<double> grid;
+  if(rank == 0){
+    grid.resize(row*column);
+  }
+  MPI_Datatype strip_type;
+  MPI_Type_vector(nlocal, column, local_section.stride(), MPI_DOUBLE, &strip_type);
+  MPI_Type_commit(&strip_type);
+  MPI_Gatherv(local_section.row(1), 1, strip_type, grid.data(), counts.data(), displs.data(), MPI_DOUBLE, 0, comm);
+  MPI_Type_free(&strip_type);
+  if(rank == 0 && reduced){
+    grid = expand_grid(grid, symmetry);
+  }
+  return grid;
+}
+
+// Impresión de la grilla a partir de franjas de filas con dos filas fantasma: el proceso 0 recolecta las filas propias de cada proceso ('MPI_Gatherv') e imprime la grilla completa.
+// Con 'symmetry' las franjas corresponden al dominio reducido y el proceso 0 reconstruye la grilla completa antes de imprimirla.
+void print_strips(const Grid2D<double>& local_section, int nlocal, int factor, MPI_Comm comm, const SymmetryDomain& symmetry = SymmetryDomain()){
+  std::vector<double> grid = gather_strips(local_section, nlocal, factor, comm, symmetry);
+  int row = 10*factor;
+  int column = 10*factor+1;
+
+  if(!grid.empty()){
+    for(int i = 0; i < row; i++){
+      for(int j = 0; j < column; j++){
+        if(j < column - 1){
+          std::cout << grid[i*column+j] << ";";
+        } else{
+          std::cout << grid[i*column+j] << std::endl;
+        }
+      }
+    }
+  }
+}
+
+// Variante con comunicación solapada de la descomposición por filas.
+// En cada iteración se actualizan primero la primera y la última fila propias (las únicas que dependen de las filas fantasma), se inician las transferencias con solicitudes persistentes ('MPI_Send_init'/'MPI_Recv_init' y 'MPI_Startall') y se actualizan las filas interiores mientras los mensajes están en tránsito. No se emplean barreras.
+// La convergencia se revisa cada 'check_every' iteraciones con una reducción no bloqueante ('MPI_Iallreduce'), que se completa al final de la iteración siguiente; por lo tanto, se realiza una iteración adicional después de alcanzar la tolerancia.
+// Cada proceso almacena siempre dos filas fantasma; los vecinos inexistentes son 'MPI_PROC_NULL'.
+void gauss_seidel_overlap(double V1, double V2, double omega, int factor, double tolerance, int check_every, const RunOptions& options = RunOptions()){
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+  }
+  if(check_every < 1){
+    std::cerr << "El intervalo de chequeo debe ser positivo!" << std::endl;
+    exit(1);
+  }
+
+  double delta = 1.0;
+  int its = 0;
+  int row = 10*factor;
+  int column = 10*factor+1;
+
+  int size, rank;
+  MPI_Init(NULL, NULL);
+  resolve_omega(omega, factor, false, MPI_COMM_WORLD);
+  start_telemetry(options, MPI_COMM_WORLD);
+  double time_1 = MPI_Wtime();
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  int start, nlocal;
+  block_range(row, size, rank, start, nlocal);
+  if(nlocal == 0){
+    std::cerr << "Hay más procesos que filas!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  int up = (rank > 0) ? rank-1 : MPI_PROC_NULL;
+  int down = (rank < size-1) ? rank+1 : MPI_PROC_NULL;
+
+  // La fila local 'i' corresponde a la fila global 'start+i-1'. La franja es una grilla rellena de 'grid2d.h' con filas alineadas de ancho 'ld'.
+  Grid2D<double> local_section(nlocal+2, column);
+  int ld = local_section.stride();
+  int iBegin = (start == 0) ? 2 : 1;
+  int iEnd = (start+nlocal == row) ? nlocal : nlocal+1;
+
+  for(int i=1; i <= nlocal; ++i){
+    int gi = start+i-1;
+    if(2*factor <= gi && gi < 8*factor){
+      local_section(i, 2*factor) = V1;
+      local_section(i, 8*factor) = V2;
+    }
+  }
+
+  // Solicitudes persistentes: envío [0] y recepción [1] de la fila superior, envío [2] y recepción [3] de la fila inferior.
+  MPI_Request request[4];
+  MPI_Send_init(local_section.row(1), column, MPI_DOUBLE, up, 1, MPI_COMM_WORLD, &request[0]);
+  MPI_Recv_init(local_section.row(0), column, MPI_DOUBLE, up, 0, MPI_COMM_WORLD, &request[1]);
+  MPI_Send_init(local_section.row(nlocal), column, MPI_DOUBLE, down, 0, MPI_COMM_WORLD, &request[2]);
+  MPI_Recv_init(local_section.row(nlocal+1), column, MPI_DOUBLE, down, 1, MPI_COMM_WORLD, &request[3]);
+
+  double halo_wait = 0.0;
+  double reduction_wait = 0.0;
+  double wait_start;
+
+  // Intercambio inicial de las filas fantasma.
+  MPI_Startall(4, request);
+  MPI_Waitall(4, request, MPI_STATUSES_IGNORE);
+
+  // Actualización de Gauss-Seidel de la fila local 'i'; regresa la mayor diferencia de la fila.
+  auto update_row = [&](int i){
+    double maxDelta = 0.0;
+    int gi = start+i-1;
+    bool plates = (2*factor <= gi && gi < 8*factor);
+    for(int j=1; j < column-1; ++j){
+      if(plates && (j == 2*factor || j == 8*factor)){
+        continue;
+      }
+      double new_value = ((1.0+omega)*0.25)*(local_section(i+1, j) + local_section(i-1, j) + local_section(i, j+1) + local_section(i, j-1)) - omega*local_section(i, j);
+      maxDelta = std::max(maxDelta, std::abs(local_section(i, j) - new_value));
+      local_section(i, j) = new_value;
+    }
+    return maxDelta;
+  };
+
+  MPI_Request reduction = MPI_REQUEST_NULL;
+  double reduction_delta[2] = {0.0, 0.0};
+  while(delta > tolerance){
+
+    double local_maxDelta = 0.0;
+
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    // Filas de frontera entre procesos.
+    if(iBegin < iEnd){
+      local_maxDelta = std::max(local_maxDelta, update_row(iBegin));
+    }
+    if(iEnd-1 > iBegin){
+      local_maxDelta = std::max(local_maxDelta, update_row(iEnd-1));
+    }
+
+    // Las filas fantasma viajan mientras se actualiza el interior.
+    MPI_Startall(4, request);
+    for(int i=iBegin+1; i < iEnd-1; ++i){
+      local_maxDelta = std::max(local_maxDelta, update_row(i));
+    }
+    }
+    {
+    TELEMETRY_SCOPE(PHASE_HALO);
+    wait_start = MPI_Wtime();
+    MPI_Waitall(4, request, MPI_STATUSES_IGNORE);
+    halo_wait += MPI_Wtime() - wait_start;
+    }
+
+    its++;
+
+    // Se completa la reducción iniciada en la iteración anterior, que tuvo una iteración completa para avanzar.
+    if(reduction != MPI_REQUEST_NULL){
+      {
+      TELEMETRY_SCOPE(PHASE_REDUCTION);
+      wait_start = MPI_Wtime();
+      MPI_Wait(&reduction, MPI_STATUS_IGNORE);
+      reduction_wait += MPI_Wtime() - wait_start;
+      }
+      delta = reduction_delta[1];
+      // En la telemetría, el residuo de la iteración 'its' es el de la iteración anterior, cuya reducción se completa aquí.
+      TELEMETRY_ITERATION(its, delta);
+      if (delta > 1e10) {
+        std::cerr << "WARNING: Delta is increasing uncontrollably, consider changing omega value." << std::endl;
+        break;
+      }
+    } else{
+      TELEMETRY_ITERATION(its, NAN);
+    }
+    if(its%check_every == 0 && delta > tolerance){
+      reduction_delta[0] = local_maxDelta;
+      MPI_Iallreduce(&reduction_delta[0], &reduction_delta[1], 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD, &reduction);
+    }
+  }
+  if(reduction != MPI_REQUEST_NULL){
+    MPI_Wait(&reduction, MPI_STATUS_IGNORE);
+  }
+  double time_2 = MPI_Wtime();
+  TELEMETRY_FINISH();
+
+  for(int r=0; r < 4; ++r){
+    MPI_Request_free(&request[r]);
+  }
+
+  if(rank == 0){
+    std::cout << "Número de procesos: " << size << std::endl;
+    std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+  }
+  if(options.benchmark){
+    if(rank == 0){
+      std::cout << "Iteraciones: " << its << std::endl;
+    }
+  } else if(options.output.empty()){
+    print_strips(local_section, nlocal, factor, MPI_COMM_WORLD);
+  } else{
+    write_binary(options.output, local_section.row(1), ld, start, nlocal, 0, column, factor, V1, V2, omega, its, MPI_COMM_WORLD);
+  }
+
+  if(options.waits){
+    report_waits(halo_wait, reduction_wait, rank, size, MPI_COMM_WORLD);
+  }
+  MPI_Finalize();
+}
+
+#ifdef _OPENMP
+// Versión híbrida MPI + OpenMP (compilar con 'compiler_hybrid.sh').
+// Cada proceso posee una franja de filas con dos filas fantasma, como en 'gauss_seidel_overlap', y la recorre con varios hilos mediante iteraciones rojo-negro con el kernel vectorizado de 'stencil_kernel.h'; cada hilo actualiza un bloque contiguo de filas.
+// Únicamente el hilo maestro realiza llamadas a MPI (nivel 'MPI_THREAD_FUNNELED'), intercambiando las filas fantasma entre ambos colores.
+// La cantidad de procesos se fija con 'mpirun -np' y la cantidad de hilos por proceso con 'OMP_NUM_THREADS'. Con un hilo por proceso se obtiene el mismo resultado que 'gauss_seidel' con el argumento 'kernel'.
+// Con 'options.symmetry' las franjas cubren únicamente el dominio reducido ('symmetry.h'): cada proceso actualiza la columna espejo de sus filas y el último proceso, que posee la fila espejo, la copia de su fila anterior.
+void gauss_seidel_hybrid(double V1, double V2, double omega, int factor, double tolerance, const std::string& kernel, const RunOptions& options = RunOptions()){
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+  }
+
+  double delta = 1.0;
+  int its = 0;
+  SymmetryDomain symmetry = symmetry_domain(options.symmetry, factor, V1, V2);
+  bool reduced = (symmetry.mode != SYMMETRY_NONE);
+  int row = symmetry.rows;
+  int column = symmetry.columns;
+
+  int size, rank, provided;
+  MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &provided);
+  resolve_omega(omega, factor, true, MPI_COMM_WORLD);
+  start_telemetry(options, MPI_COMM_WORLD);
+  double time_1 = MPI_Wtime();
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if(provided < MPI_THREAD_FUNNELED){
+    std::cerr << "La biblioteca de MPI no soporta el nivel MPI_THREAD_FUNNELED!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+
+  int start, nlocal;
+  block_range(row, size, rank, start, nlocal);
+  if(nlocal == 0){
+    std::cerr << "Hay más procesos que filas!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  // La fila espejo se copia de la fila anterior, que debe pertenecer al mismo proceso.
+  if(reduced && rank == size-1 && nlocal < 2){
+    std::cerr << "Con simetría el último proceso debe poseer al menos dos filas del dominio reducido!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  int up = (rank > 0) ? rank-1 : MPI_PROC_NULL;
+  int down = (rank < size-1) ? rank+1 : MPI_PROC_NULL;
+
+  // La fila local 'i' corresponde a la fila global 'start+i-1'.
+  // La franja local es una grilla rellena con filas alineadas de ancho 'ld'; se inicializa en paralelo con la misma división de filas de los barridos, por lo que cada hilo recorre memoria local (ver 'grid2d.h').
+  // Las filas fantasma se intercambian sin el relleno. En un cuarto de dominio la línea de la columna 8*factor queda fuera de la franja.
+  Grid2D<double> local_section(nlocal+2, column, options.huge_pages);
+  int ld = local_section.stride();
+  for(int i=1; i <= nlocal; ++i){
+    int gi = start+i-1;
+    if(2*factor <= gi && gi < 8*factor){
+      local_section(i, 2*factor) = V1;
+      if(8*factor < column){
+        local_section(i, 8*factor) = V2;
+      }
+    }
+  }
+
+  // La máscara excluye los bordes globales, las líneas de potencial y las entradas espejo, por lo que se recorren todas las filas propias.
+  StencilKernel stencil = select_kernel(kernel);
+  std::vector<unsigned char> mask = symmetry_mask(symmetry, nlocal+2, ld, start-1);
+  // Entradas espejo de las filas propias, después de cada media iteración y antes del intercambio de filas fantasma.
+  auto refresh = [&](){
+    if(!reduced){
+      return;
+    }
+    mirror_columns(local_section.data(), ld, 1, nlocal+1, symmetry);
+    if(rank == size-1){
+      mirror_row(local_section.data(), ld, nlocal, symmetry);
+    }
+  };
+
+  double halo_wait = 0.0;
+  double reduction_wait = 0.0;
+  double wait_start;
+  // Dentro de la región paralela sólo el hilo maestro lo llama, por lo que la fase de halo se descuenta del barrido que abrió el mismo hilo.
+  auto exchange_ghosts = [&](){
+    TELEMETRY_SCOPE(PHASE_HALO);
+    wait_start = MPI_Wtime();
+    MPI_Request request[4];
+    MPI_Irecv(local_section.row(0), column, MPI_DOUBLE, up, 0, MPI_COMM_WORLD, &request[0]);
+    MPI_Irecv(local_section.row(nlocal+1), column, MPI_DOUBLE, down, 1, MPI_COMM_WORLD, &request[1]);
+    MPI_Isend(local_section.row(1), column, MPI_DOUBLE, up, 1, MPI_COMM_WORLD, &request[2]);
+    MPI_Isend(local_section.row(nlocal), column, MPI_DOUBLE, down, 0, MPI_COMM_WORLD, &request[3]);
+    MPI_Waitall(4, request, MPI_STATUSES_IGNORE);
+    halo_wait += MPI_Wtime() - wait_start;
+  };
+
+  exchange_ghosts();
+  int threads = omp_get_max_threads();
+
+  while(delta > tolerance){
+
+    double local_maxDelta = 0.0;
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    #pragma omp parallel reduction(max:local_maxDelta)
+    {
+    // Bloque de filas propias [rowBegin, rowEnd) del hilo.
+    int rowBegin, rowEnd;
+    thread_rows(nlocal+2, omp_get_thread_num(), omp_get_num_threads(), rowBegin, rowEnd);
+    local_maxDelta = stencil.sweep(local_section.data(), mask.data(), ld, rowBegin, rowEnd, start-1, 0, omega);
+    #pragma omp barrier
+    #pragma omp master
+    {
+    refresh();
+    exchange_ghosts();
+    }
+    #pragma omp barrier
+    local_maxDelta = std::max(local_maxDelta, stencil.sweep(local_section.data(), mask.data(), ld, rowBegin, rowEnd, start-1, 1, omega));
+    }
+    }
+
+    its++;
+    refresh();
+    exchange_ghosts();
+
+    {
+    TELEMETRY_SCOPE(PHASE_REDUCTION);
+    wait_start = MPI_Wtime();
+    MPI_Allreduce(&local_maxDelta, &delta, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    reduction_wait += MPI_Wtime() - wait_start;
+    }
+    TELEMETRY_ITERATION(its, delta);
+
+    if (delta > 1e10) {
+      std::cerr << "WARNING: Delta is increasing uncontrollably, consider changing omega value." << std::endl;
+      break;
+    }
+  }
+  double time_2 = MPI_Wtime();
+  TELEMETRY_FINISH();
+
+  if(rank == 0){
+    std::cout << "Número de procesos: " << size << " (" << threads << " hilos por proceso, kernel " << stencil.name << ")" << std::endl;
+    std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+    if(reduced){
+      std::cout << "Simetría: " << symmetry_name(symmetry) << " (" << row << "x" << column << " entradas, " << 100.0*row*column/((10.0*factor)*(10*factor+1)) << "% de la grilla)" << std::endl;
+    }
+  }
+  if(options.benchmark){
+    if(rank == 0){
+      std::cout << "Iteraciones: " << its << std::endl;
+    }
+  } else if(options.output.empty()){
+    print_strips(local_section, nlocal, factor, MPI_COMM_WORLD, symmetry);
+  } else if(reduced){
+    // La grilla completa se reconstruye en el proceso 0, que la escribe por sí solo.
+    std::vector<double> grid = gather_strips(local_section, nlocal, factor, MPI_COMM_WORLD, symmetry);
+    if(rank == 0){
+      write_binary(options.output, grid.data(), 10*factor+1, 0, 10*factor, 0, 10*factor+1, factor, V1, V2, omega, its, MPI_COMM_SELF);
+    }
+  } else{
+    write_binary(options.output, local_section.row(1), ld, start, nlocal, 0, column, factor, V1, V2, omega, its, MPI_COMM_WORLD);
+  }
+
+  if(options.waits){
+    report_waits(halo_wait, reduction_wait, rank, size, MPI_COMM_WORLD);
+  }
+  MPI_Finalize();
+}
+#endif
+
+// Descomposición en bloques bidimensionales mediante una topología cartesiana ('MPI_Cart_create').
+// Cada proceso almacena un bloque de la grilla rodeado por celdas fantasma en los cuatro lados, por lo que el volumen de comunicación por proceso decrece con la raíz del número de procesos y se pueden emplear más procesos que filas.
+// Las filas fantasma son contiguas; las columnas fantasma se envían con un tipo derivado 'MPI_Type_vector'.
+// Se emplean iteraciones rojo-negro de Gauss-Seidel con la misma actualización del recorrido lexicográfico.
+// 'dims' permite fijar la cantidad de procesos por dimensión (filas x columnas); con valores nulos se escoge con 'MPI_Dims_create'.
+void gauss_seidel_cartesian(double V1, double V2, double omega, int factor, double tolerance, int dims[2], const RunOptions& options = RunOptions()){
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+  }
+
+  double delta = 1.0;
+  int its = 0;
+  int row = 10*factor;
+  int column = 10*factor+1;
+
+  int size, rank;
+  MPI_Init(NULL, NULL);
+  resolve_omega(omega, factor, true, MPI_COMM_WORLD);
+  start_telemetry(options, MPI_COMM_WORLD);
+  double time_1 = MPI_Wtime();
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  if(dims[0]*dims[1] != 0 && dims[0]*dims[1] != size){
+    std::cerr << "La malla de procesos no coincide con el número de procesos!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  MPI_Dims_create(size, 2, dims);
+
+  // Topología cartesiana no periódica: los vecinos fuera de la grilla son 'MPI_PROC_NULL', por lo que las transferencias con ellos no tienen efecto.
+  MPI_Comm cart;
+  int periods[2] = {0, 0};
+  MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 1, &cart);
+  MPI_Comm_rank(cart, &rank);
+  int coords[2];
+  MPI_Cart_coords(cart, rank, 2, coords);
+  int up, down, left, right;
+  MPI_Cart_shift(cart, 0, 1, &up, &down);
+  MPI_Cart_shift(cart, 1, 1, &left, &right);
+
+  int rowStart, nrows, colStart, ncols;
+  block_range(row, dims[0], coords[0], rowStart, nrows);
+  block_range(column, dims[1], coords[1], colStart, ncols);
+  if(nrows == 0 || ncols == 0){
+    std::cerr << "Hay más procesos que filas o columnas en la malla de procesos!" << std::endl;
+    MPI_Abort(cart, 1);
+  }
+
+  // Bloque local con una celda fantasma a cada lado. La entrada global (gi, gj) corresponde a la local (gi-rowStart+1, gj-colStart+1).
+  // El bloque es una grilla rellena de 'grid2d.h' de (nrows+2)x(ncols+2) entradas, con filas alineadas de ancho 'ld'.
+  Grid2D<double> local_section(nrows+2, ncols+2);
+  int ld = local_section.stride();
+
+  // Límites de iteración: se omiten los bordes de la grilla global y las celdas fantasma.
+  int iBegin = (rowStart == 0) ? 2 : 1;
+  int iEnd = (rowStart+nrows == row) ? nrows : nrows+1;
+  int jBegin = (colStart == 0) ? 2 : 1;
+  int jEnd = (colStart+ncols == column) ? ncols : ncols+1;
+
+  // Establecer las condiciones de frontera a partir de las coordenadas globales.
+  for(int i=1; i <= nrows; ++i){
+    int gi = rowStart+i-1;
+    for(int j=1; j <= ncols; ++j){
+      int gj = colStart+j-1;
+      if((2*factor <= gi && gi < 8*factor) && (gj == 2*factor)){
+        local_section(i, j) = V1;
+      }
+      if((2*factor <= gi && gi < 8*factor) && (gj == 8*factor)){
+        local_section(i, j) = V2;
+      }
+    }
+  }
+
+  // Tipo derivado para una columna del bloque: 'nrows' entradas separadas por 'ld'.
+  MPI_Datatype column_type;
+  MPI_Type_vector(nrows, 1, ld, MPI_DOUBLE, &column_type);
+  MPI_Type_commit(&column_type);
+
+  // Intercambio de las celdas fantasma con los cuatro vecinos.
+  // Envío [0-3] y recepción [4-7] hacia arriba, abajo, izquierda y derecha.
+  auto exchange_ghosts = [&](){
+    MPI_Request request[8];
+    MPI_Irecv(&local_section(0, 1), ncols, MPI_DOUBLE, up, 0, cart, &request[4]);
+    MPI_Irecv(&local_section(nrows+1, 1), ncols, MPI_DOUBLE, down, 1, cart, &request[5]);
+    MPI_Irecv(&local_section(1, 0), 1, column_type, left, 2, cart, &request[6]);
+    MPI_Irecv(&local_section(1, ncols+1), 1, column_type, right, 3, cart, &request[7]);
+    MPI_Isend(&local_section(1, 1), ncols, MPI_DOUBLE, up, 1, cart, &request[0]);
+    MPI_Isend(&local_section(nrows, 1), ncols, MPI_DOUBLE, down, 0, cart, &request[1]);
+    MPI_Isend(&local_section(1, 1), 1, column_type, left, 3, cart, &request[2]);
+    MPI_Isend(&local_section(1, ncols), 1, column_type, right, 2, cart, &request[3]);
+    MPI_Waitall(8, request, MPI_STATUSES_IGNORE);
+  };
+
+  exchange_ghosts();
+
+  double halo_wait = 0.0;
+  double reduction_wait = 0.0;
+  double wait_start;
+  while(delta > tolerance){
+
+    // Establecemos un valor inicial para la mayor diferencia.
+    double local_maxDelta = 0.0;
+
+    // Iteraciones rojo-negro sobre el bloque local: el color de cada entrada depende de su posición global, y las celdas fantasma se actualizan entre ambos colores.
+    // De esta forma el resultado no depende de la malla de procesos y el método se mantiene estable con bloques pequeños, a diferencia del recorrido lexicográfico con celdas fantasma desactualizadas.
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    for(int color=0; color < 2; ++color){
+      for(int i=iBegin; i < iEnd; ++i){
+        int gi = rowStart+i-1;
+        for(int j=jBegin + (gi+colStart+jBegin-1+color)%2; j < jEnd; j += 2){
+          int gj = colStart+j-1;
+          if((2*factor <= gi && gi < 8*factor) && (gj == 2*factor || gj == 8*factor)){
+            continue;
+          }
+          double new_value = ((1.0+omega)*0.25)*(local_section(i+1, j) + local_section(i-1, j) + local_section(i, j+1) + local_section(i, j-1)) - omega*local_section(i, j);
+          local_maxDelta = std::max(local_maxDelta, std::abs(local_section(i, j) - new_value));
+          local_section(i, j) = new_value;
+        }
+      }
+      {
+      TELEMETRY_SCOPE(PHASE_HALO);
+      wait_start = MPI_Wtime();
+      exchange_ghosts();
+      halo_wait += MPI_Wtime() - wait_start;
+      }
+    }
+    }
+
+    // Sumamos una iteración al contador.
+    its++;
+
+    // Comunicar el delta.
+    {
+    TELEMETRY_SCOPE(PHASE_REDUCTION);
+    wait_start = MPI_Wtime();
+    MPI_Allreduce(&local_maxDelta, &delta, 1, MPI_DOUBLE, MPI_MAX, cart);
+    reduction_wait += MPI_Wtime() - wait_start;
+    }
+    TELEMETRY_ITERATION(its, delta);
+
+    if (delta > 1e10) {
+      std::cerr << "WARNING: Delta is increasing uncontrollably, consider changing omega value." << std::endl;
+      break;
+    }
+  }
+  double time_2 = MPI_Wtime();
+  TELEMETRY_FINISH();
+
+  // Imprimir la matriz resultante.
+  if(rank == 0){
+    std::cout << "Número de procesos: " << size << " (" << dims[0] << "x" << dims[1] << ")" << std::endl;
+    std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+  }
+
+  if(options.benchmark){
+    if(rank == 0){
+      std::cout << "Iteraciones: " << its << std::endl;
+    }
+  } else if(!options.output.empty()){
+    write_binary(options.output, &local_section(1, 1), ld, rowStart, nrows, colStart, ncols, factor, V1, V2, omega, its, cart);
+  } else{
+  // Con bloques bidimensionales una fila de la grilla se reparte entre varios procesos, por lo que el proceso 0 recolecta los bloques (sin celdas fantasma) y luego imprime la grilla completa.
+  std::vector<double> block(nrows*ncols);
+  for(int i=0; i < nrows; ++i){
+    for(int j=0; j < ncols; ++j){
+      block[i*ncols + j] = local_section(i+1, j+1);
+    }
+  }
+  if(rank != 0){
+    MPI_Send(block.data(), nrows*ncols, MPI_DOUBLE, 0, 4, cart);
+  } else{
+    std::vector<double> grid(row*column);
+    for(int r=0; r < size; ++r){
+      int rc[2], rs, nr, cs, nc;
+      MPI_Cart_coords(cart, r, 2, rc);
+      block_range(row, dims[0], rc[0], rs, nr);
+      block_range(column, dims[1], rc[1], cs, nc);
+      std::vector<double> received(nr*nc);
+      if(r == 0){
+        received = block;
+      } else{
+        MPI_Recv(received.data(), nr*nc, MPI_DOUBLE, r, 4, cart, MPI_STATUS_IGNORE);
+      }
+      for(int i=0; i < nr; ++i){
+        for(int j=0; j < nc; ++j){
+          grid[(rs+i)*column + (cs+j)] = received[i*nc + j];
+        }
+      }
+    }
+
+    for(int i = 0; i < row; i++){
+      for(int j = 0; j < column; j++){
+        if(j < column - 1){
+          std::cout << grid[i*column+j] << ";";
+        } else{
+          std::cout << grid[i*column+j] << std::endl;
+        }
+      }
+    }
+  }
+  }
+
+  if(options.waits){
+    report_waits(halo_wait, reduction_wait, rank, size, cart);
+  }
+  MPI_Type_free(&column_type);
+  MPI_Comm_free(&cart);
+  MPI_Finalize();
+}
+
+// Gradiente conjugado precondicionado (PCG) sin matriz explícita, con la descomposición por filas.
+// Se resuelve A*x = b sobre las entradas libres, donde A es el laplaciano de cinco puntos (4 en la diagonal y -1 con cada vecina libre); todos los vectores se almacenan como franjas con dos filas fantasma, igual que 'local_section', y son nulos en las entradas fijas.
+// Únicamente la dirección de búsqueda 'p' requiere filas fantasma: se intercambian con solicitudes persistentes, como en 'gauss_seidel_overlap', mientras se aplica el operador a las filas que no dependen de ellas. Los productos punto se reducen con 'MPI_Allreduce'.
+// Precondicionadores ('preconditioner'):
+//   'ssor': una iteración de Gauss-Seidel simétrico rojo-negro (rojo, negro, rojo) sobre la franja de cada proceso, con filas fantasma nulas. Es un precondicionador de bloques simétrico que no requiere comunicación.
+//   'jacobi': z = r/4. Como la diagonal de A es constante, realiza las mismas iteraciones que 'ninguno'; se incluye como referencia.
+//   'ninguno': gradiente conjugado sin precondicionar.
+// La convergencia se evalúa con el mayor residuo de la grilla.
+void conjugate_gradient(double V1, double V2, int factor, double tolerance, const std::string& preconditioner, const RunOptions& options = RunOptions()){
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+  }
+  if(preconditioner != "ssor" && preconditioner != "jacobi" && preconditioner != "ninguno"){
+    std::cerr << "Precondicionador no reconocido: " << preconditioner << ". Las opciones son 'ssor', 'jacobi' y 'ninguno'." << std::endl;
+    exit(1);
+  }
+
+  int its = 0;
+  int row = 10*factor;
+  int column = 10*factor+1;
+
+  int size, rank;
+  MPI_Init(NULL, NULL);
+  double time_1 = MPI_Wtime();
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  int start, nlocal;
+  block_range(row, size, rank, start, nlocal);
+  if(nlocal == 0){
+    std::cerr << "Hay más procesos que filas!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  int up = (rank > 0) ? rank-1 : MPI_PROC_NULL;
+  int down = (rank < size-1) ? rank+1 : MPI_PROC_NULL;
+
+  // La fila local 'i' corresponde a la fila global 'start+i-1'. La franja es una grilla rellena de 'grid2d.h' y los vectores de trabajo comparten su ancho de fila 'ld';
+  // las entradas de relleno se marcan como fijas, por lo que permanecen nulas en todos los vectores.
+  Grid2D<double> local_section(nlocal+2, column);
+  int ld = local_section.stride();
+  size_t n = local_section.size();
+  double* phi = local_section.data();
+  std::vector<char> fixed(n, 1);
+  for(int i=1; i <= nlocal; ++i){
+    int gi = start+i-1;
+    bool plates = (2*factor <= gi && gi < 8*factor);
+    if(plates){
+      local_section(i, 2*factor) = V1;
+      local_section(i, 8*factor) = V2;
+    }
+    for(int j=1; j < column-1; ++j){
+      fixed[i*ld + j] = (gi == 0 || gi == row-1 || (plates && (j == 2*factor || j == 8*factor)));
+    }
+  }
+
+  std::vector<double> r(n, 0.0), z(n, 0.0), p(n, 0.0), q(n, 0.0), r_old(n, 0.0);
+
+  // Solicitudes persistentes sobre las filas de 'p': envío [0] y recepción [1] de la fila superior, envío [2] y recepción [3] de la fila inferior.
+  MPI_Request request[4];
+  MPI_Send_init(&p[ld], column, MPI_DOUBLE, up, 1, MPI_COMM_WORLD, &request[0]);
+  MPI_Recv_init(&p[0], column, MPI_DOUBLE, up, 0, MPI_COMM_WORLD, &request[1]);
+  MPI_Send_init(&p[nlocal*ld], column, MPI_DOUBLE, down, 0, MPI_COMM_WORLD, &request[2]);
+  MPI_Recv_init(&p[(nlocal+1)*ld], column, MPI_DOUBLE, down, 1, MPI_COMM_WORLD, &request[3]);
+
+  double halo_wait = 0.0;
+  double reduction_wait = 0.0;
+  double wait_start;
+
+  // q = A*p en la fila local 'i'; regresa la contribución de la fila al producto punto p·q.
+  auto apply_row = [&](int i){
+    double dot = 0.0;
+    for(int j=1; j < column-1; ++j){
+      int k = i*ld + j;
+      q[k] = fixed[k] ? 0.0 : 4.0*p[k] - p[k+1] - p[k-1] - p[k+ld] - p[k-ld];
+      dot += p[k]*q[k];
+    }
+    return dot;
+  };
+  // Aplicación del operador con el intercambio de las filas fantasma de 'p' solapado con las filas interiores. Regresa el producto punto global p·q.
+  auto apply_operator = [&](){
+    MPI_Startall(4, request);
+    double dot = 0.0;
+    for(int i=2; i < nlocal; ++i){
+      dot += apply_row(i);
+    }
+    wait_start = MPI_Wtime();
+    MPI_Waitall(4, request, MPI_STATUSES_IGNORE);
+    halo_wait += MPI_Wtime() - wait_start;
+    dot += apply_row(1);
+    if(nlocal > 1){
+      dot += apply_row(nlocal);
+    }
+    double global_dot;
+    wait_start = MPI_Wtime();
+    MPI_Allreduce(&dot, &global_dot, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    reduction_wait += MPI_Wtime() - wait_start;
+    return global_dot;
+  };
+  auto precondition = [&](){
+    if(preconditioner == "ssor"){
+      std::fill(z.begin(), z.end(), 0.0);
+      const int colors[3] = {0, 1, 0};
+      for(int color : colors){
+        for(int i=1; i <= nlocal; ++i){
+          int gi = start+i-1;
+          for(int j=1 + (gi+1+color)%2; j < column-1; j += 2){
+            int k = i*ld + j;
+            if(!fixed[k]){
+              z[k] = 0.25*(z[k+1] + z[k-1] + z[k+ld] + z[k-ld] + r[k]);
+            }
+          }
+        }
+      }
+    } else if(preconditioner == "jacobi"){
+      for(size_t k=0; k < n; ++k){
+        z[k] = 0.25*r[k];
+      }
+    } else{
+      z = r;
+    }
+  };
+  auto global_max = [&](double local){
+    double global;
+    wait_start = MPI_Wtime();
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    reduction_wait += MPI_Wtime() - wait_start;
+    return global;
+  };
+
+  // Residuo inicial r = b - A*phi: se aplica el operador a la grilla inicial, que contiene los valores fijos.
+  p.assign(phi, phi + n);
+  apply_operator();
+  double maxResidual = 0.0;
+  for(size_t k=0; k < n; ++k){
+    r[k] = -q[k];
+    maxResidual = std::max(maxResidual, std::abs(r[k]));
+  }
+  maxResidual = global_max(maxResidual);
+  precondition();
+  double local_dots[2] = {0.0, 0.0};
+  for(size_t k=0; k < n; ++k){
+    local_dots[0] += r[k]*z[k];
+  }
+  double rz;
+  MPI_Allreduce(&local_dots[0], &rz, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  p = z;
+
+  while(maxResidual > tolerance){
+    double alpha = rz/apply_operator();
+    double local_max = 0.0;
+    for(size_t k=0; k < n; ++k){
+      phi[k] += alpha*p[k];
+      r_old[k] = r[k];
+      r[k] -= alpha*q[k];
+      local_max = std::max(local_max, std::abs(r[k]));
+    }
+    its++;
+    maxResidual = global_max(local_max);
+    if(maxResidual <= tolerance){
+      break;
+    }
+    if(maxResidual > 1e10){
+      if(rank == 0){
+        std::cerr << "WARNING: Residual is increasing uncontrollably, consider changing the preconditioner." << std::endl;
+      }
+      break;
+    }
+    precondition();
+    // Fórmula de Polak-Ribière: beta = z·(r - r_old)/(z_old·r_old). Se reducen ambos productos en una sola operación.
+    local_dots[0] = 0.0;
+    local_dots[1] = 0.0;
+    for(size_t k=0; k < n; ++k){
+      local_dots[0] += r[k]*z[k];
+      local_dots[1] += r_old[k]*z[k];
+    }
+    double dots[2];
+    wait_start = MPI_Wtime();
+    MPI_Allreduce(local_dots, dots, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    reduction_wait += MPI_Wtime() - wait_start;
+    double beta = (dots[0] - dots[1])/rz;
+    rz = dots[0];
+    for(size_t k=0; k < n; ++k){
+      p[k] = z[k] + beta*p[k];
+    }
+  }
+  double time_2 = MPI_Wtime();
+
+  for(int k=0; k < 4; ++k){
+    MPI_Request_free(&request[k]);
+  }
+
+  if(rank == 0){
+    std::cout << "Número de procesos: " << size << std::endl;
+    std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+  }
+  if(options.benchmark){
+    if(rank == 0){
+      std::cout << "Iteraciones: " << its << std::endl;
+    }
+  } else if(options.output.empty()){
+    print_strips(local_section, nlocal, factor, MPI_COMM_WORLD);
+  } else{
+    write_binary(options.output, local_section.row(1), ld, start, nlocal, 0, column, factor, V1, V2, 0.0, its, MPI_COMM_WORLD);
+  }
+
+  if(options.waits){
+    report_waits(halo_wait, reduction_wait, rank, size, MPI_COMM_WORLD);
+  }
+  MPI_Finalize();
+}
+
+// Desde la terminal se puede escoger el kernel vectorizado rojo-negro: 'mpirun -np 2 a.out --kernel auto'.
+// La descomposición en bloques bidimensionales se activa con '--cartesiano'; '--malla PxQ' fija la cantidad de procesos por fila y columna de la malla.
+// La variante con comunicación solapada se activa con '--solapado', y '--chequeo K' fija cada cuántas iteraciones se revisa la convergencia.
+// El gradiente conjugado precondicionado se activa con '--pcg' (ver 'conjugate_gradient'); '--precondicionador P' escoge 'ssor' (por defecto), 'jacobi' o 'ninguno'.
+// La versión híbrida MPI + OpenMP se activa con '--hibrido' (compilando con 'compiler_hybrid.sh'); acepta '--kernel K' (por defecto 'auto').
+// Con '--salida archivo.bin' la grilla se escribe en formato binario con MPI-IO en lugar de imprimirse (ver 'write_binary'); 'plot.py archivo.bin' lee el archivo directamente.
+// Con '--esperas' se reporta el tiempo de espera en comunicación de cada proceso (por ejemplo, para comparar 'mpirun -np 4 a.out --esperas' con 'mpirun -np 4 a.out --solapado --esperas').
+// '--factor N', '--tolerancia T' y '--omega W' cambian el factor de escala, la tolerancia y el parámetro de sobre-relajación; '--omega auto' escoge el óptimo estimado (ver 'resolve_omega').
+// '--respaldo ARCHIVO' escribe colectivamente un punto de control cada 100 iteraciones (o cada N con '--respaldo-cada N') y al finalizar; '--reanudar' continúa desde él si existe, y '--inicial ARCHIVO' interpola como valor inicial una solución de otro factor de escala (ver 'load_strip_state').
+// Los puntos de control están disponibles en la descomposición por filas (lexicográfica o con '--kernel').
+// '--paginas-grandes' reserva la franja local de la versión híbrida con páginas grandes transparentes.
+// '--simetria S' resuelve la versión híbrida sobre un dominio reducido por simetría ('mitad', 'cuarto', 'auto' o 'ninguna', ver 'symmetry.h'); la grilla completa se reconstruye en el proceso 0.
+// '--telemetria ARCHIVO' escribe en 'ARCHIVO.<rango>' (o en 'ARCHIVO' con un único proceso) una línea JSON por iteración con el residuo global y los tiempos de barrido, halo y reducción del proceso; '--contadores' agrega los contadores de hardware.
+// Requiere compilar con '-DCAPACITOR_TELEMETRY' (ver 'telemetry.h' y 'start_telemetry') y no está disponible con '--pcg'.
+// Con '--benchmark' no se imprime la grilla, sino únicamente el tiempo y la cantidad de iteraciones (ver 'src/benchmark').
+int main(int argc, char* argv[]){
   int factor = 10;
   double volt1 = 1.0;
   double volt2 = -1.0;
   double omega = 0.8;
   double tolerance = 1e-4;
-  gauss_seidel(volt1, volt2, omega, factor, tolerance);
+  std::string kernel = "";
+  bool cartesian = false;
+  bool overlap = false;
+  bool hybrid = false;
+  bool pcg = false;
+  std::string preconditioner = "ssor";
+  RunOptions options;
+  int check_every = 1;
+  int dims[2] = {0, 0};
+  for(int a = 1; a < argc; ++a){
+    std::string arg = argv[a];
+    if(arg == "--kernel" && a+1 < argc){
+      kernel = argv[++a];
+    } else if(arg == "--cartesiano"){
+      cartesian = true;
+    } else if(arg == "--salida" && a+1 < argc){
+      options.output = argv[++a];
+    } else if(arg == "--hibrido"){
+      hybrid = true;
+    } else if(arg == "--solapado"){
+      overlap = true;
+    } else if(arg == "--chequeo" && a+1 < argc){
+      check_every = std::stoi(argv[++a]);
+    } else if(arg == "--pcg"){
+      pcg = true;
+    } else if(arg == "--precondicionador" && a+1 < argc){
+      preconditioner = argv[++a];
+    } else if(arg == "--esperas"){
+      options.waits = true;
+    } else if(arg == "--benchmark"){
+      options.benchmark = true;
+    } else if(arg == "--paginas-grandes"){
+      options.huge_pages = true;
+    } else if(arg == "--simetria" && a+1 < argc){
+      options.symmetry = argv[++a];
+    } else if(arg == "--telemetria" && a+1 < argc){
+      options.telemetry = argv[++a];
+    } else if(arg == "--contadores"){
+      options.counters = true;
+    } else if(arg == "--respaldo" && a+1 < argc){
+      options.checkpoint.path = argv[++a];
+    } else if(arg == "--respaldo-cada" && a+1 < argc){
+      options.checkpoint.every = std::stoi(argv[++a]);
+    } else if(arg == "--reanudar"){
+      options.checkpoint.resume = true;
+    } else if(arg == "--inicial" && a+1 < argc){
+      options.checkpoint.initial = argv[++a];
+    } else if(arg == "--factor" && a+1 < argc){
+      factor = std::stoi(argv[++a]);
+    } else if(arg == "--tolerancia" && a+1 < argc){
+      tolerance = std::stod(argv[++a]);
+    } else if(arg == "--omega" && a+1 < argc){
+      omega = parse_omega(argv[++a]);
+    } else if(arg == "--malla" && a+1 < argc){
+      cartesian = true;
+      if(std::sscanf(argv[++a], "%dx%d", &dims[0], &dims[1]) != 2 || dims[0] <= 0 || dims[1] <= 0){
+        std::cerr << "La malla de procesos debe tener la forma PxQ!" << std::endl;
+        exit(1);
+      }
+    } else{
+      std::cerr << "Argumento no reconocido: " << arg << std::endl;
+      exit(1);
+    }
+  }
+  if(cartesian && !kernel.empty()){
+    std::cerr << "El kernel vectorizado sólo está disponible con la descomposición por filas!" << std::endl;
+    exit(1);
+  }
+  if(overlap && (cartesian || !kernel.empty())){
+    std::cerr << "La variante con comunicación solapada sólo está disponible con el recorrido lexicográfico por filas!" << std::endl;
+    exit(1);
+  }
+  if(hybrid && (cartesian || overlap)){
+    std::cerr << "La versión híbrida sólo está disponible con la descomposición por filas!" << std::endl;
+    exit(1);
+  }
+  if(pcg && (cartesian || overlap || hybrid || !kernel.empty())){
+    std::cerr << "El gradiente conjugado sólo está disponible con la descomposición por filas, sin '--kernel', '--solapado' ni '--hibrido'!" << std::endl;
+    exit(1);
+  }
+  if(options.symmetry != "ninguna" && !hybrid){
+    std::cerr << "El dominio reducido por simetría sólo está disponible en la versión híbrida ('--hibrido')!" << std::endl;
+    exit(1);
+  }
+  if(pcg && !options.telemetry.empty()){
+    std::cerr << "La telemetría no está disponible en el gradiente conjugado!" << std::endl;
+    exit(1);
+  }
+  const CheckpointSettings& checkpoint = options.checkpoint;
+  if((!checkpoint.path.empty() || checkpoint.resume || !checkpoint.initial.empty()) && (pcg || cartesian || overlap || hybrid)){
+    std::cerr << "Los puntos de control y el valor inicial sólo están disponibles en la descomposición por filas, sin '--solapado', '--hibrido' ni '--pcg'!" << std::endl;
+    exit(1);
+  }
+  if(checkpoint.every < 1){
+    std::cerr << "La frecuencia de los puntos de control debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+  }
+  if(checkpoint.resume && checkpoint.path.empty()){
+    std::cerr << "La opción '--reanudar' requiere el archivo del punto de control ('--respaldo')!" << std::endl;
+    exit(1);
+  }
+  if(pcg){
+    conjugate_gradient(volt1, volt2, factor, tolerance, preconditioner, options);
+  } else if(hybrid){
+#ifdef _OPENMP
+    gauss_seidel_hybrid(volt1, volt2, omega, factor, tolerance, kernel.empty() ? "auto" : kernel, options);
+#else
+    std::cerr << "La versión híbrida requiere compilar con OpenMP ('compiler_hybrid.sh')!" << std::endl;
+    exit(1);
+#endif
+  } else if(cartesian){
+    gauss_seidel_cartesian(volt1, volt2, omega, factor, tolerance, dims, options);
+  } else if(overlap){
+    gauss_seidel_overlap(volt1, volt2, omega, factor, tolerance, check_every, options);
+  } else{
+    gauss_seidel(volt1, volt2, omega, factor, tolerance, kernel, options);
+  }
   return 0;
 }
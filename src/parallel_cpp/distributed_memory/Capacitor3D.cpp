@@ -0,0 +1,251 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+#include <mpi.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "grid3d.h"
+#include "telemetry.h"
+
+// Capacitor de placas paralelas finitas en 3D con MPI ('grid3d.h'), descomponiendo la grilla en franjas de planos (slabs).
+// Es la extensión de la descomposición por filas de 'Capacitor.cpp': cada proceso posee un bloque contiguo de planos con dos planos fantasma, que se intercambian completos
+// (incluyendo el relleno, ya que cada plano es contiguo en memoria) entre las dos medias iteraciones rojo-negro y al final de cada iteración.
+// Si se compila con OpenMP cada proceso recorre su franja con varios hilos y únicamente el hilo maestro realiza llamadas a MPI ('MPI_THREAD_FUNNELED'), como en la versión híbrida 2D.
+
+// Reparto de 'n' planos entre 'parts' procesos, con el mismo criterio de la descomposición por filas.
+void block_range(int n, int parts, int coord, int& start, int& count){
+  count = n/parts;
+  int rest = n%parts;
+  start = count*coord + std::min(coord, rest);
+  if(coord < rest){
+    count++;
+  }
+}
+
+// Función que resuelve el capacitor 3D. 'tileRows' y 'tileColumns' son los bloques del recorrido de cada plano (ver 'tiles_3d').
+// Se reporta la memoria total y por proceso, las actualizaciones por segundo y el tiempo de espera en el intercambio de planos fantasma.
+void gauss_seidel_3d(double V1, double V2, double omega, int factor, double tolerance, int tileRows, int tileColumns, bool blocked, const std::string& output, int precision, bool benchmark,
+                     const std::string& telemetry_path, bool counters){
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+  }
+
+  int size, rank, provided;
+  MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &provided);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if(provided < MPI_THREAD_FUNNELED){
+    std::cerr << "La biblioteca de MPI no soporta el nivel MPI_THREAD_FUNNELED!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  if(!telemetry_path.empty()){
+    telemetry_open(telemetry_path, counters, rank, size);
+  }
+
+  Shape3D shape = shape_3d(factor);
+  if(blocked){
+    tiles_3d(shape, tileRows, tileColumns);
+  } else{
+    tileRows = shape.rows-2;
+    tileColumns = shape.columns-2;
+  }
+  int start, nlocal;
+  block_range(shape.planes, size, rank, start, nlocal);
+  if(nlocal == 0){
+    std::cerr << "Hay más procesos que planos!" << std::endl;
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  int up = (rank > 0) ? rank-1 : MPI_PROC_NULL;
+  int down = (rank < size-1) ? rank+1 : MPI_PROC_NULL;
+
+  // El plano local 'k' corresponde al plano global 'start+k-1'; los planos 0 y nlocal+1 son fantasma.
+  Grid2D<double> local_section((nlocal+2)*shape.plane_rows, shape.columns);
+  set_plates_3d(local_section, shape, nlocal+2, start-1, V1, V2);
+  int plane = shape.plane_rows*local_section.stride();
+
+  double halo_wait = 0.0;
+  double wait_start;
+  auto exchange_ghosts = [&](){
+    TELEMETRY_SCOPE(PHASE_HALO);
+    wait_start = MPI_Wtime();
+    MPI_Request request[4];
+    MPI_Irecv(local_section.row(0), plane, MPI_DOUBLE, up, 0, MPI_COMM_WORLD, &request[0]);
+    MPI_Irecv(local_section.row((nlocal+1)*shape.plane_rows), plane, MPI_DOUBLE, down, 1, MPI_COMM_WORLD, &request[1]);
+    MPI_Isend(local_section.row(shape.plane_rows), plane, MPI_DOUBLE, up, 1, MPI_COMM_WORLD, &request[2]);
+    MPI_Isend(local_section.row(nlocal*shape.plane_rows), plane, MPI_DOUBLE, down, 0, MPI_COMM_WORLD, &request[3]);
+    MPI_Waitall(4, request, MPI_STATUSES_IGNORE);
+    halo_wait += MPI_Wtime() - wait_start;
+  };
+
+  exchange_ghosts();
+  int threads = 1;
+#ifdef _OPENMP
+  threads = omp_get_max_threads();
+#endif
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  double time_1 = MPI_Wtime();
+  double delta = 1.0;
+  int its = 0;
+  while(delta > tolerance){
+
+    double local_maxDelta = 0.0;
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    #pragma omp parallel reduction(max:local_maxDelta)
+    {
+    // Bloque de planos propios [kBegin, kEnd) del hilo.
+    int kBegin = 1;
+    int kEnd = nlocal+1;
+#ifdef _OPENMP
+    thread_rows(nlocal+2, omp_get_thread_num(), omp_get_num_threads(), kBegin, kEnd);
+#endif
+    local_maxDelta = sweep_3d(local_section, shape, kBegin, kEnd, start-1, 0, omega, tileRows, tileColumns);
+    #pragma omp barrier
+    #pragma omp master
+    exchange_ghosts();
+    #pragma omp barrier
+    local_maxDelta = std::max(local_maxDelta, sweep_3d(local_section, shape, kBegin, kEnd, start-1, 1, omega, tileRows, tileColumns));
+    }
+    }
+
+    its++;
+    exchange_ghosts();
+
+    {
+    TELEMETRY_SCOPE(PHASE_REDUCTION);
+    MPI_Allreduce(&local_maxDelta, &delta, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    }
+    TELEMETRY_ITERATION(its, delta);
+
+    if(delta > 1e10){
+      std::cerr << "WARNING: Delta is increasing uncontrollably, consider changing omega value." << std::endl;
+      break;
+    }
+  }
+  double time_2 = MPI_Wtime();
+  TELEMETRY_FINISH();
+
+  double max_wait;
+  MPI_Reduce(&halo_wait, &max_wait, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  if(rank == 0){
+    std::cout << "Número de procesos: " << size << " (" << threads << " hilos por proceso)" << std::endl;
+    std::cout << "Grilla: " << shape.planes << "x" << shape.rows << "x" << shape.columns << "; Bloque: " << tileRows << "x" << tileColumns << std::endl;
+    std::cout << "Memoria de la grilla (MB): " << bytes_3d(shape, shape.planes)/1e6 << "; Memoria por proceso, con planos fantasma (MB): " << bytes_3d(shape, nlocal+2)/1e6 << std::endl;
+    std::cout << "Tiempo transcurrido: " << time_2 - time_1 << "; Espera máxima de planos fantasma: " << max_wait << std::endl;
+    std::cout << "Millones de actualizaciones por segundo: " << updates_3d(shape)*its/(time_2 - time_1)/1e6 << std::endl;
+    std::cout << "Diferencia máxima: " << delta << std::endl;
+  }
+  if(benchmark){
+    if(rank == 0){
+      std::cout << "Iteraciones: " << its << std::endl;
+    }
+    MPI_Finalize();
+    return;
+  }
+
+  // Salida sin recolectar la grilla: con '.npy' cada proceso escribe sus planos en su posición del archivo con MPI-IO; en CSV el proceso que posee el plano central k = 5*factor lo envía al proceso 0.
+  if(npy_output(output)){
+    // El proceso 0 crea el archivo con el encabezado; los datos del plano global K inician en header_bytes + K*rows*columns dobles.
+    long header_bytes = 0;
+    if(rank == 0){
+      std::FILE* file = open_npy_3d(output, shape, header_bytes);
+      if(std::fclose(file) != 0){
+        std::cerr << "Error al escribir el archivo de salida: " << output << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+      }
+    }
+    MPI_Bcast(&header_bytes, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+    MPI_File file;
+    if(MPI_File_open(MPI_COMM_WORLD, output.c_str(), MPI_MODE_WRONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS){
+      std::cerr << "No se pudo abrir el archivo de salida: " << output << std::endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    // Un plano contiguo a la vez, de forma que la memoria adicional sea la de un plano y no la de la franja.
+    size_t packed_plane = (size_t)shape.rows*shape.columns;
+    std::vector<double> plane_buffer(packed_plane);
+    for(int k=0; k < nlocal; ++k){
+      pack_3d(local_section, shape, k+1, 1, plane_buffer.data());
+      MPI_Offset offset = (MPI_Offset)header_bytes + (MPI_Offset)(start + k)*packed_plane*sizeof(double);
+      MPI_File_write_at(file, offset, plane_buffer.data(), (int)packed_plane, MPI_DOUBLE, MPI_STATUS_IGNORE);
+    }
+    MPI_File_close(&file);
+  } else{
+    int middle = 5*factor;
+    int owner = (start <= middle && middle < start + nlocal) ? rank : 0;
+    int root_owner;
+    MPI_Allreduce(&owner, &root_owner, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    std::vector<double> plane;
+    if(rank == root_owner){
+      plane = middle_plane_3d(local_section, shape, middle - start + 1);
+    }
+    if(root_owner != 0){
+      if(rank == root_owner){
+        MPI_Send(plane.data(), (int)plane.size(), MPI_DOUBLE, 0, 2, MPI_COMM_WORLD);
+      } else if(rank == 0){
+        plane.resize((size_t)shape.rows*shape.columns);
+        MPI_Recv(plane.data(), (int)plane.size(), MPI_DOUBLE, root_owner, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      }
+    }
+    if(rank == 0){
+      write_grid(output, plane, shape.rows, shape.columns, precision);
+    }
+  }
+  MPI_Finalize();
+}
+
+// Uso: 'mpirun -np 4 a.out' (compilar con 'compiler_3d.sh'); con OpenMP la cantidad de hilos por proceso se fija con 'OMP_NUM_THREADS'.
+// Opciones: '--factor N', '--tolerancia T', '--omega W', '--bloque FxC' ('0x0' para recorrer planos completos), '--salida ARCHIVO' ('.npy' para el arreglo 3D o CSV del corte central k = 5*factor),
+// '--precision P', '--telemetria ARCHIVO' y '--contadores' (ver 'telemetry.h') y '--benchmark' (sin escribir la grilla), con el mismo significado que en la versión de memoria compartida.
+int main(int argc, char* argv[]){
+  int factor = 10;
+  double volt1 = 1.0;
+  double volt2 = -1.0;
+  double omega = 0.9;
+  double tolerance = 1e-4;
+  int tileRows = 0;
+  int tileColumns = 0;
+  bool blocked = true;
+  std::string output = "";
+  int precision = 4;
+  bool benchmark = false;
+  std::string telemetry_path = "";
+  bool counters = false;
+  for(int a = 1; a < argc; ++a){
+    std::string arg = argv[a];
+    if(arg == "--factor" && a+1 < argc){
+      factor = std::stoi(argv[++a]);
+    } else if(arg == "--tolerancia" && a+1 < argc){
+      tolerance = std::stod(argv[++a]);
+    } else if(arg == "--omega" && a+1 < argc){
+      omega = std::stod(argv[++a]);
+    } else if(arg == "--bloque" && a+1 < argc){
+      if(std::sscanf(argv[++a], "%dx%d", &tileRows, &tileColumns) != 2 || tileRows < 0 || tileColumns < 0){
+        std::cerr << "El bloque debe tener la forma FxC!" << std::endl;
+        exit(1);
+      }
+      blocked = (tileRows > 0 || tileColumns > 0);
+    } else if(arg == "--salida" && a+1 < argc){
+      output = argv[++a];
+    } else if(arg == "--precision" && a+1 < argc){
+      precision = std::stoi(argv[++a]);
+    } else if(arg == "--telemetria" && a+1 < argc){
+      telemetry_path = argv[++a];
+    } else if(arg == "--contadores"){
+      counters = true;
+    } else if(arg == "--benchmark"){
+      benchmark = true;
+    } else{
+      std::cerr << "Argumento no reconocido: " << arg << std::endl;
+      exit(1);
+    }
+  }
+  gauss_seidel_3d(volt1, volt2, omega, factor, tolerance, tileRows, tileColumns, blocked, output, precision, benchmark, telemetry_path, counters);
+  return 0;
+}
@@ -0,0 +1,9 @@
+#!/bin/bash
+
+# Capacitor de placas finitas en 3D con descomposición en franjas de planos (MPI + OpenMP).
+# La cantidad de procesos se fija con '-np' y la cantidad de hilos por proceso con 'OMP_NUM_THREADS'.
+mpicxx -O2 -fopenmp -I../../common Capacitor3D.cpp -o capacitor3d
+
+OMP_NUM_THREADS=2 mpirun -np 2 --bind-to none -x OMP_NUM_THREADS capacitor3d --benchmark "$@"
+#OMP_NUM_THREADS=2 mpirun -np 2 --bind-to none -x OMP_NUM_THREADS capacitor3d "$@" | tail -n 100 > capacitor.csv
+#python3 plot.py
@@ -1,8 +1,18 @@
 #!/bin/bash
 
-mpicxx Capacitor.cpp
+mpicxx -I../../common Capacitor.cpp
 
 #mpirun -np 2 a.out | head -n 2
 
+# Descomposición en bloques bidimensionales (malla de procesos automática o fija con '--malla PxQ').
+#mpirun -np 4 a.out --cartesiano | tail -n +3 > capacitor.csv
+
+# Comunicación solapada con solicitudes persistentes; '--esperas' reporta el tiempo de espera de cada proceso en la salida de error.
+#mpirun -np 4 a.out --solapado --chequeo 10 --esperas | head -n 2
+
+# Salida binaria con MPI-IO: todos los procesos escriben su franja en 'capacitor.bin', que 'plot.py' lee directamente.
+#mpirun -np 2 a.out --salida capacitor.bin | head -n 2
+#python3 plot.py capacitor.bin
+
 mpirun -np 2 a.out | tail -n +3 > capacitor.csv
 python3 plot.py
@@ -0,0 +1,11 @@
+#!/bin/bash
+
+# Versión híbrida MPI + OpenMP: cada proceso recorre su franja de filas con varios hilos.
+# La cantidad de procesos se fija con '-np' y la cantidad de hilos por proceso con 'OMP_NUM_THREADS'.
+# '--bind-to none' evita que todos los hilos de un proceso queden fijados al mismo núcleo.
+mpicxx -O2 -fopenmp -I../../common Capacitor.cpp
+
+#OMP_NUM_THREADS=4 mpirun -np 2 --bind-to none -x OMP_NUM_THREADS a.out --hibrido --esperas | head -n 2
+
+OMP_NUM_THREADS=2 mpirun -np 2 --bind-to none -x OMP_NUM_THREADS a.out --hibrido | tail -n +3 > capacitor.csv
+python3 plot.py
@@ -1,12 +1,27 @@
 #!/usr/bin/env python3
 
+import sys
 import matplotlib.pyplot as plt
 import pandas as pd
 import numpy as np
 
-file = pd.read_csv('capacitor.csv',delimiter=';', header=None)
+# Encabezado de 64 bytes de la salida binaria ('--salida'), seguido de la grilla como dobles little-endian.
+HEADER = np.dtype([('magic', 'S8'), ('rows', '<i4'), ('columns', '<i4'), ('factor', '<i4'), ('iterations', '<i4'),
+                   ('V1', '<f8'), ('V2', '<f8'), ('omega', '<f8'), ('reserved', 'V16')])
+
+# Uso: 'python3 plot.py [archivo]'; por defecto se lee 'capacitor.csv'.
+name = sys.argv[1] if len(sys.argv) > 1 else 'capacitor.csv'
+
+if name.endswith('.bin'):
+    header = np.fromfile(name, dtype=HEADER, count=1)[0]
+    if header['magic'] != b'CAPGRID1':
+        sys.exit('El archivo ' + name + ' no tiene el formato de salida binaria!')
+    # La grilla se mapea directamente desde el archivo, sin copiarla ni interpretar texto.
+    data = np.memmap(name, dtype='<f8', mode='r', offset=HEADER.itemsize, shape=(header['rows'], header['columns']))
+else:
+    file = pd.read_csv(name, delimiter=';', header=None)
+    data = file.to_numpy(dtype=float)
 
-data = file.to_numpy(dtype=float)
 plt.imshow(data)
 plt.gray()
 plt.show()
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <sys/time.h>
+#include <omp.h>
+#include "grid3d.h"
+#include "telemetry.h"
+
+// Función que regresa la medición del tiempo actual.
+double seconds(){
+  struct timeval tmp;
+  double sec;
+  gettimeofday( &tmp, (struct timezone *)0 );
+  sec = tmp.tv_sec + ((double)tmp.tv_usec)/1000000.0;
+
+  return sec;
+}
+
+// Iteraciones rojo-negro de Gauss-Seidel/SOR sobre la grilla 3D del capacitor de placas finitas ('grid3d.h').
+// Cada hilo recibe un bloque contiguo de planos, el mismo que inicializó la grilla en paralelo ('Grid2D'), y lo recorre por bloques de 'tileRows' x 'tileColumns' entradas (ver 'tiles_3d');
+// entre las dos medias iteraciones se sincronizan los hilos con una barrera. El argumento 'check_every' permite evaluar la convergencia únicamente cada 'check_every' iteraciones.
+int gauss_seidel_3d(Grid2D<double>& phi, const Shape3D& shape, double omega, double tolerance, int check_every, int tileRows, int tileColumns){
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+  }
+
+  if(check_every < 1){
+    std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+  }
+
+  double delta = 1.0;
+  double maxDelta = 0.0;
+  int its = 0;
+  while(delta > tolerance){
+    maxDelta = 0.0;
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    #pragma omp parallel reduction(max:maxDelta)
+    {
+    // Bloque de planos interiores [kBegin, kEnd) del hilo.
+    int kBegin, kEnd;
+    thread_rows(shape.planes, omp_get_thread_num(), omp_get_num_threads(), kBegin, kEnd);
+    maxDelta = sweep_3d(phi, shape, kBegin, kEnd, 0, 0, omega, tileRows, tileColumns);
+    #pragma omp barrier
+    maxDelta = std::max(maxDelta, sweep_3d(phi, shape, kBegin, kEnd, 0, 1, omega, tileRows, tileColumns));
+    }
+    }
+
+    its += 1;
+    TELEMETRY_ITERATION(its, (its % check_every == 0) ? maxDelta : NAN);
+    if(its % check_every == 0){
+      delta = maxDelta;
+    }
+    if(delta > 1e10){
+      std::cerr << "La diferencia crece sin control; se debe reducir omega." << std::endl;
+      exit(1);
+    }
+  }
+  std::cout << "Diferencia máxima: " << maxDelta << std::endl;
+  return its;
+}
+
+// Capacitor de placas paralelas finitas en 3D con OpenMP (compilar con 'compiler_3d.sh'). La cantidad de hilos se fija con 'OMP_NUM_THREADS'.
+// Se reporta la memoria de la grilla y la cantidad de actualizaciones por segundo, de forma que se pueda dimensionar una ejecución de producción; luego se escribe el corte central k = 5*factor en CSV.
+// Opciones:
+//   '--factor N' cambia el factor de escala: la grilla tiene (10*N)x(10*N)x(10*N+1) entradas, unos 8*N^3 KB.
+//   '--tolerancia T', '--omega W' y '--chequeo N' cambian la tolerancia, el parámetro de sobre-relajación y la frecuencia de evaluación de la convergencia.
+//   '--bloque FxC' fija las filas y columnas de los bloques del recorrido (por defecto se escogen para la caché L2, ver 'tiles_3d'); '--bloque 0x0' recorre planos completos sin bloques.
+//   '--salida ARCHIVO' escribe la grilla: '.npy' para el arreglo 3D completo o CSV del corte central con cualquier otra extensión. '--precision P' cambia las cifras del CSV.
+//   '--telemetria ARCHIVO' y '--contadores' escriben la telemetría por iteración (requiere compilar con '-DCAPACITOR_TELEMETRY', ver 'telemetry.h').
+//   '--benchmark' reporta el tiempo y las iteraciones sin escribir la grilla (ver 'src/benchmark').
+int main(int argc, char* argv[]){
+  int factor = 10;
+  double volt1 = 1.0;
+  double volt2 = -1.0;
+  double omega = 0.9;
+  double tolerance = 1e-4;
+  int check_every = 1;
+  int tileRows = 0;
+  int tileColumns = 0;
+  bool blocked = true;
+  std::string output = "";
+  int precision = 4;
+  bool benchmark = false;
+  std::string telemetry_path = "";
+  bool counters = false;
+  for(int a = 1; a < argc; ++a){
+    std::string arg = argv[a];
+    if(arg == "--factor" && a+1 < argc){
+      factor = std::stoi(argv[++a]);
+    } else if(arg == "--tolerancia" && a+1 < argc){
+      tolerance = std::stod(argv[++a]);
+    } else if(arg == "--omega" && a+1 < argc){
+      omega = std::stod(argv[++a]);
+    } else if(arg == "--chequeo" && a+1 < argc){
+      check_every = std::stoi(argv[++a]);
+    } else if(arg == "--bloque" && a+1 < argc){
+      if(std::sscanf(argv[++a], "%dx%d", &tileRows, &tileColumns) != 2 || tileRows < 0 || tileColumns < 0){
+        std::cerr << "El bloque debe tener la forma FxC!" << std::endl;
+        exit(1);
+      }
+      blocked = (tileRows > 0 || tileColumns > 0);
+    } else if(arg == "--salida" && a+1 < argc){
+      output = argv[++a];
+    } else if(arg == "--precision" && a+1 < argc){
+      precision = std::stoi(argv[++a]);
+    } else if(arg == "--telemetria" && a+1 < argc){
+      telemetry_path = argv[++a];
+    } else if(arg == "--contadores"){
+      counters = true;
+    } else if(arg == "--benchmark"){
+      benchmark = true;
+    } else{
+      std::cerr << "Argumento no reconocido: " << arg << std::endl;
+      exit(1);
+    }
+  }
+
+  Shape3D shape = shape_3d(factor);
+  if(blocked){
+    tiles_3d(shape, tileRows, tileColumns);
+  } else{
+    tileRows = shape.rows-2;
+    tileColumns = shape.columns-2;
+  }
+  // La grilla se inicializa en paralelo con la misma división de planos de los barridos (ver 'grid2d.h').
+  Grid2D<double> phi(shape.planes*shape.plane_rows, shape.columns);
+  set_plates_3d(phi, shape, shape.planes, 0, volt1, volt2);
+
+  if(!telemetry_path.empty()){
+    telemetry_open(telemetry_path, counters);
+  }
+  double time_1 = seconds();
+  int iterations = gauss_seidel_3d(phi, shape, omega, tolerance, check_every, tileRows, tileColumns);
+  double time_2 = seconds();
+  TELEMETRY_FINISH();
+
+  std::cout << "Número de procesos: " << omp_get_max_threads() << std::endl;
+  std::cout << "Grilla: " << shape.planes << "x" << shape.rows << "x" << shape.columns << "; Bloque: " << tileRows << "x" << tileColumns << std::endl;
+  std::cout << "Memoria de la grilla (MB): " << bytes_3d(shape, shape.planes)/1e6 << std::endl;
+  std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+  std::cout << "Millones de actualizaciones por segundo: " << updates_3d(shape)*iterations/(time_2 - time_1)/1e6 << std::endl;
+  if(benchmark){
+    std::cout << "Iteraciones: " << iterations << std::endl;
+    return 0;
+  }
+  write_grid_3d(output, phi, shape, precision);
+}
@@ -1,29 +1,22 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <map>
 #include <sys/time.h>
 #include <omp.h>
-
-// Función generadora de la grilla inicial.
-std::vector<double> grid_generator(int factor, double V1, double V2, double boundary = 0.0){
-
-	// Manejo de excepciones para evitar factores de escala no válidos.
-	if(factor < 1){
-	    std::cerr << "El factor de escala debe ser un número entero mayor que cero!" << std::endl;
-	    exit(1);
-	}
-
-	// Generar la grilla con las dimensiones (10*factor x 10*factor+1) y las líneas de potencial con V1, V2
-	int column = 10*factor+1;
-	std::vector<double> phi(10*factor*column); 
-	for(int i=2*factor; i < 8*factor; ++i){
-		phi[i*column+2*factor] = V1;
-		phi[i*column+8*factor] = V2;
-	}
-
-	return phi;
-}
-
+#include "grid2d.h"
+#include "temporal_blocking.h"
+#include "active_tiles.h"
+#include "symmetry.h"
+#include "grid_output.h"
+#include "omega_tuning.h"
+#include "checkpoint.h"
+#include "telemetry.h"
 
 // Función que regresa la medición del tiempo actual.
 double seconds(){
@@ -38,10 +31,12 @@ double seconds(){
 
 // Función que se encarga de las iteraciones del método de Gauss-Seidel.
 // Como variables de entrada se encuentra una referencia a la grilla, el valor 'omega', el factor de escala y la tolerancia con la que se desea evaluar.
-int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tolerance){
+// El argumento 'check_every' permite evaluar la convergencia únicamente cada 'check_every' iteraciones.
+// Con 'checkpoint' se escribe periódicamente la grilla en un punto de control ('checkpoint.h'), entre iteraciones y fuera de las regiones paralelas; al reanudar, el conteo continúa desde 'checkpoint.start'.
+int gauss_seidel(GridVector& phi, double omega, int factor, double tolerance, int check_every = 1, const CheckpointSettings& checkpoint = CheckpointSettings()){
 
 	// Manejo de excepciones, evitar que el factor de escala ingresado en este método sea diferente al utilizado al momento de generar la grilla.
-	if(phi.size() != (10*factor)*(10*factor+1)){
+	if(phi.size() != (size_t)(10*factor)*(10*factor+1)){
 		std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
 		exit(1);
 	}
@@ -52,12 +47,18 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
 		exit(1);
 	}
 
-	// Se realiza un deep copy de la grilla. Nótese que la sintaxis es de una copia superficial, sin embargo, la biblioteca 'vector' se encarga de gestionar esta operación como una copia profunda.
-	std::vector<double> phiCopy = phi;
+	// Manejo de excepciones para asegurar una frecuencia de evaluación de la convergencia válida.
+	if(check_every < 1){
+		std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+		exit(1);
+	}
+
+	// La diferencia máxima entre iteraciones se calcula durante el mismo recorrido de la grilla, como una reducción 'max' entre los hilos, por lo que no se necesita una copia de la grilla.
 	double delta = 1.0;
-	double diff;
-	double maxDelta;
-	int its = 0;
+	double maxDelta = 0.0;
+	// La variable 'check' indica si en la iteración actual se evalúa la convergencia.
+	bool check;
+	int its = checkpoint.start;
 	// Se define la variable 'column' para simplificar la apariencia del código.
 	int column = 10*factor+1;
 	int initValue;
@@ -68,7 +69,11 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
 
 	// Vamos a recorrer la grilla por líneas diagonales, empezando por un primer ciclo encargado de ir variando las diagonales de tal forma que las entradas iniciales de cada diagonal se vayan desplazando a lo largo de la primera columna. Una vez se alcance la última fila de la primera columna, se realizará un desplazamiento de la entrada inicial de cada diagonal a lo largo de toda la fila mencionada, que corresponde al segundo ciclo.
 	while(delta > tolerance){
-		
+
+		check = ((its+1) % check_every == 0);
+		maxDelta = 0.0;
+		{
+		TELEMETRY_SCOPE(PHASE_SWEEP);
 		// Se establece 'initValue = 1' para el primer ciclo. Corresponderá a la columna que posee las entradas iniciales de las diagonales.
 		initValue = 1;
 		// Primer ciclo. initValue se encargará de iniciar las diagonales en la segunda columna de la grilla. Se evita la primera columna por las condiciones de frontera.
@@ -79,7 +84,8 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
 		
 		for(int i=1; i < 10*factor-1; ++i){
 			// Se paraleliza el recorrido para cada línea diagonal. (Fork_1)
-			#pragma omp for schedule(dynamic)
+			// Cada hilo acumula su diferencia máxima y la cláusula 'reduction' las combina al final de cada diagonal.
+			#pragma omp for schedule(dynamic) reduction(max:maxDelta)
 			for(int d=0; d < i; ++d){ // 'd' corresponde al ciclo que recorre las líneas diagonales.
 			// Nótese que ahora las entradas de la grilla corresponden a '[i-d,j+d]'.
 			// Para el primer ciclo, j->initValue. Por lo tanto: '[i-d,initValue+d]'.
@@ -87,7 +93,11 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
 				if((2*factor <= (i-d) && (i-d) < 8*factor) && ((initValue+d) == 2*factor || (initValue+d) == 8*factor)){
 					continue;
 				} else{
-					phi[(i-d)*column + (initValue+d)] = ((1.0+omega)*0.25)*(phi[(i-d+1)*column + (initValue+d)] + phi[(i-d-1)*column + (initValue+d)] + phi[(i-d)*column + (initValue+d+1)] + phi[(i-d)*column + (initValue+d-1)]) - omega*phi[(i-d)*column + (initValue+d)];
+					double new_value = ((1.0+omega)*0.25)*(phi[(i-d+1)*column + (initValue+d)] + phi[(i-d-1)*column + (initValue+d)] + phi[(i-d)*column + (initValue+d+1)] + phi[(i-d)*column + (initValue+d-1)]) - omega*phi[(i-d)*column + (initValue+d)];
+					if(check){
+						maxDelta = std::max(maxDelta, std::abs(new_value - phi[(i-d)*column + (initValue+d)]));
+					}
+					phi[(i-d)*column + (initValue+d)] = new_value;
 				}
 			}
 		}
@@ -101,33 +111,110 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
 		{
 		for(int j=2; j < 10*factor; ++j){
 			// Se paraleliza el recorrido para cada línea diagonal.
-			#pragma omp for schedule(dynamic)
+			#pragma omp for schedule(dynamic) reduction(max:maxDelta)
 			for(int d=0; d < 10*factor-j; ++d){
 			// Nótese que, nuevamente, las entradas de la grilla corresponden a '[i-d,j+d]'.
 			// Para el segundo ciclo, i->initValue. Por lo tanto: '[initValue-d,j+d]'.
 				if((2*factor <= (initValue-d) && (initValue-d) < 8*factor) && ((j+d) == 2*factor || (j+d) == 8*factor)){
                                         continue;
                                 } else{
-                                        phi[(initValue-d)*column + (j+d)] = ((1.0+omega)*0.25)*(phi[(initValue-d+1)*column + (j+d)] + phi[(initValue-d-1)*column + (j+d)] + phi[(initValue-d)*column + (j+d+1)] + phi[(initValue-d)*column + (j+d-1)]) - omega*phi[(initValue-d)*column + (j+d)];
+                                        double new_value = ((1.0+omega)*0.25)*(phi[(initValue-d+1)*column + (j+d)] + phi[(initValue-d-1)*column + (j+d)] + phi[(initValue-d)*column + (j+d+1)] + phi[(initValue-d)*column + (j+d-1)]) - omega*phi[(initValue-d)*column + (j+d)];
+					if(check){
+						maxDelta = std::max(maxDelta, std::abs(new_value - phi[(initValue-d)*column + (j+d)]));
+					}
+					phi[(initValue-d)*column + (j+d)] = new_value;
 				}
 			}
 		}
 		} // Se cierra el ambiente OMP para el segundo ciclo. (Join_2)
-		
+		}
+
+		its += 1;
+		TELEMETRY_ITERATION(its, check ? maxDelta : NAN);
+		if(check){
+			delta = maxDelta;
+		}
+		save_checkpoint(checkpoint, phi, factor, omega, its);
+	}
+	save_checkpoint(checkpoint, phi, factor, omega, its, true);
+
+	double time_2 = seconds();
+	std::cout << "Número de procesos: " << num_procs << std::endl;
+	std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+	std::cout << "Diferencia máxima: " << maxDelta << std::endl;
+	return its;
+}
+
+// Función que realiza las iteraciones de Gauss-Seidel/SOR con ordenamiento rojo-negro (tablero de ajedrez).
+// Las entradas con (i+j) par se consideran 'rojas' y las impares 'negras'. Cada entrada roja depende únicamente de entradas negras y viceversa, por lo que cada media iteración puede paralelizarse por completo, recorriendo la grilla fila por fila.
+// A diferencia del método de wavefront, únicamente se tienen dos barreras implícitas por iteración, en lugar de una barrera por cada diagonal.
+// Los argumentos son los mismos que en 'gauss_seidel'.
+int gauss_seidel_redblack(GridVector& phi, double omega, int factor, double tolerance, int check_every = 1, const CheckpointSettings& checkpoint = CheckpointSettings()){
+
+	// Manejo de excepciones, evitar que el factor de escala ingresado en este método sea diferente al utilizado al momento de generar la grilla.
+	if(phi.size() != (size_t)(10*factor)*(10*factor+1)){
+		std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+		exit(1);
+	}
+
+	// Manejo de excepciones para asegurar que el valor de tolerancia sea un número válido.
+	if(tolerance <= 0){
+		std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+		exit(1);
+	}
+
+	// Manejo de excepciones para asegurar una frecuencia de evaluación de la convergencia válida.
+	if(check_every < 1){
+		std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+		exit(1);
+	}
+
+	double delta = 1.0;
+	double maxDelta = 0.0;
+	bool check;
+	int its = checkpoint.start;
+	int column = 10*factor+1;
+
+	double time_1 = seconds();
+	int num_procs = omp_get_max_threads();
+
+	while(delta > tolerance){
+
+		check = ((its+1) % check_every == 0);
 		maxDelta = 0.0;
-		for(int i=1; i < 10*factor-1; ++i){
-			for(int j=1; j < column-1; ++j){
-				diff = std::abs(phi[i*column + j] - phiCopy[i*column + j]);
-				if(diff > maxDelta){
-					maxDelta = diff;
+
+		// Primera media iteración (color = 0) para las entradas rojas, segunda (color = 1) para las negras.
+		{
+		TELEMETRY_SCOPE(PHASE_SWEEP);
+		for(int color=0; color < 2; ++color){
+			// Cada hilo recibe un bloque contiguo de filas. Dentro de cada fila se recorren las columnas del color correspondiente con paso 2.
+			#pragma omp parallel for schedule(static) reduction(max:maxDelta)
+			for(int i=1; i < 10*factor-1; ++i){
+				// Primera columna de la fila 'i' que cumple (i+j)%2 == color.
+				int jStart = 1 + (i+1+color)%2;
+				for(int j=jStart; j < column-1; j += 2){
+					if((2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor)){
+						continue;
+					} else{
+						double new_value = ((1.0+omega)*0.25)*(phi[(i+1)*column + j] + phi[(i-1)*column + j] + phi[i*column + (j+1)] + phi[i*column + (j-1)]) - omega*phi[i*column + j];
+						if(check){
+							maxDelta = std::max(maxDelta, std::abs(new_value - phi[i*column + j]));
+						}
+						phi[i*column + j] = new_value;
+					}
 				}
 			}
 		}
+		}
 
-		delta = maxDelta;
-		phiCopy = phi;
 		its += 1;
+		TELEMETRY_ITERATION(its, check ? maxDelta : NAN);
+		if(check){
+			delta = maxDelta;
+		}
+		save_checkpoint(checkpoint, phi, factor, omega, its);
 	}
+	save_checkpoint(checkpoint, phi, factor, omega, its, true);
 
 	double time_2 = seconds();
 	std::cout << "Número de procesos: " << num_procs << std::endl;
@@ -136,26 +223,1120 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
 	return its;
 }
 
-void print_grid(std::vector<double> &matrix, int factor){
-  std::cout.precision(4);
-  for (int i = 0; i < 10*factor; i++){
-    for (int j = 0; j < 10*factor+1; j++){
-      if (j<10*factor){
-      std::cout<< matrix[i*(10*factor+1)+j] << ";";
-      }
-      else{
-      std::cout<<matrix[i*(10*factor+1)+j]<< std::endl;
-      }
-    }
-  }
+// Función que realiza las iteraciones rojo-negro empleando el kernel vectorizado de 'stencil_kernel.h', sobre una grilla rellena con filas alineadas.
+// Cada hilo recibe un bloque contiguo de filas y aplica el kernel a todo su bloque; entre las dos medias iteraciones se sincronizan los hilos con una barrera.
+// El argumento 'kernel' permite escoger el conjunto de instrucciones: 'auto', 'avx512', 'avx2' o 'scalar'. Con 'huge_pages' la grilla rellena se reserva con páginas grandes.
+// Con 'depth' mayor que 1 se aplican 'depth' iteraciones por bloque de filas con el frente de onda de bloques de 'temporal_blocking.h', en lugar de la división en bloques por hilo;
+// la convergencia se evalúa al final de cada bloque temporal, por lo que el número de iteraciones es un múltiplo de 'depth'.
+// Con 'symmetry' se itera únicamente sobre la mitad o el cuarto de la grilla ('symmetry.h'): después de cada media iteración un hilo actualiza las entradas espejo, y al final se reconstruye la grilla completa en 'phi'.
+// Con 'active.enabled' se barren únicamente los bloques que aún cambian, repartidos entre los hilos ('active_tiles.h'); la convergencia se evalúa en los barridos completos de verificación.
+// Si 'skipped' no es nulo, recibe la fracción de bloques omitidos por el modo incremental.
+int gauss_seidel_simd(GridVector& phi, double omega, int factor, double tolerance, int check_every = 1, const std::string& kernel = "auto", bool huge_pages = false, int depth = 1,
+                      const SymmetryDomain& symmetry = SymmetryDomain(), const ActiveTileSettings& active = ActiveTileSettings(), double* skipped = nullptr){
+
+	if(phi.size() != (size_t)(10*factor)*(10*factor+1)){
+		std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+		exit(1);
+	}
+
+	if(tolerance <= 0){
+		std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+		exit(1);
+	}
+
+	if(check_every < 1){
+		std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+		exit(1);
+	}
+
+	if(symmetry.mode != SYMMETRY_NONE && depth > 1){
+		std::cerr << "El dominio reducido por simetría no está disponible con el bloque temporal!" << std::endl;
+		exit(1);
+	}
+
+	if(active.enabled && (depth > 1 || symmetry.mode != SYMMETRY_NONE || check_every > 1)){
+		std::cerr << "El modo incremental no está disponible con el bloque temporal, la simetría ni '--chequeo'!" << std::endl;
+		exit(1);
+	}
+
+	StencilKernel stencil = select_kernel(kernel);
+	bool reduced = (symmetry.mode != SYMMETRY_NONE);
+	int rows = reduced ? symmetry.rows : 10*factor;
+	int column = reduced ? symmetry.columns : 10*factor+1;
+	// La grilla rellena se inicializa y se copia en paralelo con la misma división de filas del ciclo, por lo que cada hilo recorre memoria local (ver 'grid2d.h').
+	Grid2D<double> padded(rows, column, huge_pages);
+	padded.load(reduced ? reduce_grid(phi, symmetry) : phi);
+	int stride = padded.stride();
+	std::vector<unsigned char> mask = reduced ? symmetry_mask(symmetry, rows, stride) : capacitor_mask(rows, column, stride, factor);
+	int blockRows = temporal_block_rows<double>(stride, depth);
+	check_temporal_depth(depth, blockRows);
+	ActiveTiles tiles;
+	if(active.enabled){
+		tiles = active_tiles(rows, stride, active);
+	}
+
+	double delta = 1.0;
+	double maxDelta = 0.0;
+	int its = 0;
+
+	double time_1 = seconds();
+	int num_procs = omp_get_max_threads();
+
+	while(delta > tolerance){
+
+		maxDelta = 0.0;
+		{
+		TELEMETRY_SCOPE(PHASE_SWEEP);
+		if(active.enabled){
+			// Los bloques activos y sus vecinos se reparten entre los hilos en cada color.
+			schedule_tiles(tiles, its, tolerance);
+			maxDelta = active_sweeps(stencil, padded.data(), mask.data(), stride, tiles, omega);
+		} else if(depth > 1){
+			maxDelta = temporal_sweeps_pipelined(stencil, padded.data(), mask.data(), stride, rows, depth, blockRows, omega);
+		} else{
+		#pragma omp parallel reduction(max:maxDelta)
+		{
+		// Bloque de filas interiores [rowBegin, rowEnd) del hilo.
+		int rowBegin, rowEnd;
+		thread_rows(rows, omp_get_thread_num(), omp_get_num_threads(), rowBegin, rowEnd);
+		maxDelta = stencil.sweep(padded.data(), mask.data(), stride, rowBegin, rowEnd, 0, 0, omega);
+		#pragma omp barrier
+		if(reduced){
+			#pragma omp single
+			refresh_mirror(padded.data(), stride, symmetry);
+		}
+		maxDelta = std::max(maxDelta, stencil.sweep(padded.data(), mask.data(), stride, rowBegin, rowEnd, 0, 1, omega));
+		}
+		refresh_mirror(padded.data(), stride, symmetry);
+		}
+		}
+
+		// Se evalúa la convergencia si el bloque de iteraciones alcanzó un múltiplo de 'check_every'.
+		int previous = its;
+		its += depth;
+		bool check = active.enabled ? tiles.full : (its/check_every != previous/check_every);
+		TELEMETRY_ITERATION(its, check ? maxDelta : NAN);
+		if(check){
+			delta = maxDelta;
+		}
+	}
+
+	double time_2 = seconds();
+	if(reduced){
+		GridVector section((size_t)rows*column);
+		padded.store(section);
+		phi = expand_grid(section, symmetry);
+	} else{
+		padded.store(phi);
+	}
+	std::cout << "Número de procesos: " << num_procs << std::endl;
+	std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+	std::cout << "Kernel: " << stencil.name << std::endl;
+	if(reduced){
+		std::cout << "Simetría: " << symmetry_name(symmetry) << " (" << rows << "x" << column << " entradas, " << 100.0*rows*column/((10.0*factor)*(10*factor+1)) << "% de la grilla)" << std::endl;
+	}
+	if(depth > 1){
+		std::cout << "Bloque temporal: " << depth << " iteraciones en bloques de " << blockRows << " filas (hasta " << 2*depth << " hilos en paralelo)" << std::endl;
+	}
+	if(active.enabled){
+		report_active_tiles(tiles);
+	}
+	if(skipped != nullptr){
+		*skipped = active.enabled ? skipped_fraction(tiles) : 0.0;
+	}
+	std::cout << "Diferencia máxima: " << maxDelta << std::endl;
+	return its;
+}
+
+// Función que realiza las iteraciones de Gauss-Seidel/SOR mediante un wavefront de bloques (tiles), empleando dependencias de tareas de OpenMP.
+// La grilla interior se divide en bloques de 'tile' x 'tile' entradas. Cada bloque se recorre en orden lexicográfico por una única tarea, la cual inicia tan pronto como finalizan los bloques vecinos superior (norte) e izquierdo (oeste), sin barreras globales entre diagonales.
+// Como cada entrada utiliza los valores nuevos de sus vecinas superior e izquierda y los valores anteriores de sus vecinas inferior y derecha, el resultado es idéntico al de 'gauss_seidel' de la versión serial, incluyendo el número de iteraciones.
+// Los argumentos son los mismos que en 'gauss_seidel', junto con el tamaño de los bloques.
+int gauss_seidel_tiled(GridVector& phi, double omega, int factor, double tolerance, int check_every = 1, int tile = 64){
+
+	if(phi.size() != (size_t)(10*factor)*(10*factor+1)){
+		std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+		exit(1);
+	}
+
+	if(tolerance <= 0){
+		std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+		exit(1);
+	}
+
+	if(check_every < 1){
+		std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+		exit(1);
+	}
+
+	// Manejo de excepciones para asegurar un tamaño de bloque válido.
+	if(tile < 1){
+		std::cerr << "El tamaño de bloque debe ser un número entero mayor que cero!" << std::endl;
+		exit(1);
+	}
+
+	double delta = 1.0;
+	double maxDelta = 0.0;
+	bool check;
+	int its = 0;
+	int column = 10*factor+1;
+	// Número de bloques en cada dirección. Las filas y columnas interiores van de 1 a 10*factor-2 y de 1 a column-2, respectivamente.
+	int tileRows = (10*factor-2 + tile-1)/tile;
+	int tileColumns = (column-2 + tile-1)/tile;
+	// Arreglo auxiliar cuyas entradas únicamente se emplean como identificadores de las dependencias entre tareas.
+	std::vector<char> dependency(tileRows*tileColumns);
+	// Sólo aparece en las cláusulas 'depend', que el compilador no cuenta como uso.
+	[[maybe_unused]] char* dep = dependency.data();
+	// Diferencia máxima de cada bloque, combinada una vez que finalizan todas las tareas de la iteración.
+	std::vector<double> tileDelta(tileRows*tileColumns);
+
+	double time_1 = seconds();
+	int num_procs = omp_get_max_threads();
+
+	while(delta > tolerance){
+
+		check = ((its+1) % check_every == 0);
+
+		// Un único hilo genera las tareas de la iteración y el resto las ejecuta conforme se satisfacen sus dependencias.
+		// La barrera implícita al final de la región paralela garantiza que todas las tareas hayan finalizado.
+		{
+		TELEMETRY_SCOPE(PHASE_SWEEP);
+		#pragma omp parallel
+		#pragma omp single
+		{
+		for(int bi=0; bi < tileRows; ++bi){
+			for(int bj=0; bj < tileColumns; ++bj){
+				// Los bloques de la primera fila o columna no tienen vecino norte u oeste; en ese caso la dependencia apunta al mismo bloque, lo cual no agrega restricciones.
+				int north = (bi > 0) ? (bi-1)*tileColumns + bj : bi*tileColumns + bj;
+				int west = (bj > 0) ? bi*tileColumns + (bj-1) : bi*tileColumns + bj;
+				#pragma omp task firstprivate(bi, bj) depend(in: dep[north], dep[west]) depend(out: dep[bi*tileColumns + bj])
+				{
+				double localDelta = 0.0;
+				int iEnd = std::min(1 + (bi+1)*tile, 10*factor-1);
+				int jEnd = std::min(1 + (bj+1)*tile, column-1);
+				for(int i=1 + bi*tile; i < iEnd; ++i){
+					for(int j=1 + bj*tile; j < jEnd; ++j){
+						if((2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor)){
+							continue;
+						} else{
+							double new_value = ((1.0+omega)*0.25)*(phi[(i+1)*column + j] + phi[(i-1)*column + j] + phi[i*column + (j+1)] + phi[i*column + (j-1)]) - omega*phi[i*column + j];
+							if(check){
+								localDelta = std::max(localDelta, std::abs(new_value - phi[i*column + j]));
+							}
+							phi[i*column + j] = new_value;
+						}
+					}
+				}
+				tileDelta[bi*tileColumns + bj] = localDelta;
+				}
+			}
+		}
+		}
+		}
+
+		its += 1;
+		if(check){
+			TELEMETRY_SCOPE(PHASE_CHECK);
+			maxDelta = 0.0;
+			for(size_t t=0; t < tileDelta.size(); ++t){
+				maxDelta = std::max(maxDelta, tileDelta[t]);
+			}
+			delta = maxDelta;
+		}
+		TELEMETRY_ITERATION(its, check ? maxDelta : NAN);
+	}
+
+	double time_2 = seconds();
+	std::cout << "Número de procesos: " << num_procs << std::endl;
+	std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+	std::cout << "Diferencia máxima: " << maxDelta << std::endl;
+	return its;
+}
+
+// Estructura que representa un nivel de la jerarquía de multigrid.
+// El nivel 0 corresponde a la grilla original y cada nivel siguiente posee aproximadamente la mitad de filas y columnas, de forma que la entrada (I,J) de un nivel grueso coincide con la entrada (2I,2J) del nivel fino.
+struct Level{
+	int rows;
+	int columns;
+	// Solución (en el nivel 0) o corrección (en los niveles gruesos).
+	GridVector u;
+	// Término fuente de la ecuación discreta A*u = f.
+	GridVector f;
+	// Residuo r = f - A*u.
+	GridVector r;
+	// Indica las entradas con condiciones de Dirichlet: los bordes de la grilla y las líneas de potencial.
+	std::vector<char> fixed;
+	// Coeficientes de la matriz A de los niveles gruesos: 9 coeficientes por entrada, con índice k = (di+1)*3 + (dj+1) para el vecino (i+di, j+dj).
+	// En el nivel 0 se encuentra vacío, ya que se emplea directamente la diferencia central de cinco puntos.
+	std::vector<double> stencil;
+};
+
+// Coeficiente de la matriz A del nivel 'level' que acopla la entrada libre (i,j) con su vecina libre (i+di,j+dj).
+// Las entradas fijas no forman parte de las incógnitas, por lo que sus coeficientes son nulos.
+double coefficient(const Level& level, int i, int j, int di, int dj){
+	if(!level.stencil.empty()){
+		return level.stencil[(i*level.columns + j)*9 + (di+1)*3 + (dj+1)];
+	}
+	if(level.fixed[(i+di)*level.columns + (j+dj)]){
+		return 0.0;
+	}
+	if(di == 0 && dj == 0){
+		return 4.0;
+	}
+	return (std::abs(di) + std::abs(dj) == 1) ? -1.0 : 0.0;
+}
+
+// Peso de la interpolación bilineal de la entrada gruesa I sobre la entrada fina i, en una dirección.
+double interpolation_weight(int i, int I){
+	int distance = std::abs(i - 2*I);
+	if(distance == 0){
+		return 1.0;
+	}
+	return (distance == 1) ? 0.5 : 0.0;
+}
+
+// Construcción de la matriz del nivel grueso mediante el producto de Galerkin A_c = R*A*P, donde P es la interpolación bilineal hacia las entradas finas libres y R = P^T/4 la ponderación completa.
+// A diferencia de discretizar nuevamente la ecuación de Laplace, este producto respeta la posición de las líneas de potencial y de los bordes aunque no coincidan con entradas del nivel grueso.
+// Cada columna N escribe en los coeficientes de sus vecinas gruesas, por lo que esta construcción se mantiene secuencial. Se realiza una única vez por nivel, antes de iterar.
+void galerkin(const Level& fine, Level& coarse){
+	coarse.stencil.assign(coarse.rows*coarse.columns*9, 0.0);
+	// Para cada entrada gruesa N se aplica A a la columna N de P, la cual es no nula en un bloque 3x3 alrededor de la entrada fina (2N_i, 2N_j). El resultado 'v' es no nulo en un bloque 5x5.
+	for(int NI=1; NI < coarse.rows-1; ++NI){
+		for(int NJ=1; NJ < coarse.columns-1; ++NJ){
+			if(coarse.fixed[NI*coarse.columns + NJ]){
+				continue;
+			}
+			double v[5][5] = {};
+			for(int pi=-1; pi <= 1; ++pi){
+				for(int pj=-1; pj <= 1; ++pj){
+					int i = 2*NI+pi;
+					int j = 2*NJ+pj;
+					if(i >= fine.rows-1 || j >= fine.columns-1 || fine.fixed[i*fine.columns + j]){
+						continue;
+					}
+					double p = interpolation_weight(i, NI)*interpolation_weight(j, NJ);
+					for(int di=-1; di <= 1; ++di){
+						for(int dj=-1; dj <= 1; ++dj){
+							if(fine.fixed[(i+di)*fine.columns + (j+dj)]){
+								continue;
+							}
+							// La matriz es simétrica, por lo que A[(i+di,j+dj),(i,j)] = A[(i,j),(i+di,j+dj)].
+							v[pi+di+2][pj+dj+2] += coefficient(fine, i, j, di, dj)*p;
+						}
+					}
+				}
+			}
+			// Se aplica R = P^T/4 al vector 'v' para obtener la columna N de la matriz gruesa.
+			for(int vi=0; vi < 5; ++vi){
+				for(int vj=0; vj < 5; ++vj){
+					if(v[vi][vj] == 0.0){
+						continue;
+					}
+					int i = 2*NI+vi-2;
+					int j = 2*NJ+vj-2;
+					for(int CI=(i-1)/2; CI <= (i+1)/2; ++CI){
+						for(int CJ=(j-1)/2; CJ <= (j+1)/2; ++CJ){
+							double w = interpolation_weight(i, CI)*interpolation_weight(j, CJ);
+							if(w == 0.0 || coarse.fixed[CI*coarse.columns + CJ]){
+								continue;
+							}
+							coarse.stencil[(CI*coarse.columns + CJ)*9 + (NI-CI+1)*3 + (NJ-CJ+1)] += 0.25*w*v[vi][vj];
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// Función que construye la jerarquía de niveles a partir de la grilla generada por 'grid_generator'.
+// Se reducen las dimensiones mientras el nivel grueso tenga al menos 5 filas y 5 columnas.
+std::vector<Level> build_levels(const GridVector& phi, int factor){
+	std::vector<Level> levels(1);
+	Level& fine = levels[0];
+	fine.rows = 10*factor;
+	fine.columns = 10*factor+1;
+	fine.u = phi;
+	fine.f.assign(fine.rows*fine.columns, 0.0);
+	fine.r.assign(fine.rows*fine.columns, 0.0);
+	fine.fixed.assign(fine.rows*fine.columns, 0);
+	for(int i=0; i < fine.rows; ++i){
+		for(int j=0; j < fine.columns; ++j){
+			bool border = (i == 0 || j == 0 || i == fine.rows-1 || j == fine.columns-1);
+			bool plate = (2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor);
+			fine.fixed[i*fine.columns + j] = (border || plate);
+		}
+	}
+
+	while(levels.back().rows/2+1 >= 5 && levels.back().columns/2+1 >= 5){
+		const Level& prev = levels.back();
+		Level coarse;
+		coarse.rows = prev.rows/2+1;
+		coarse.columns = prev.columns/2+1;
+		coarse.u.assign(coarse.rows*coarse.columns, 0.0);
+		coarse.f.assign(coarse.rows*coarse.columns, 0.0);
+		coarse.r.assign(coarse.rows*coarse.columns, 0.0);
+		coarse.fixed.assign(coarse.rows*coarse.columns, 0);
+		// Una entrada gruesa es fija si está en el borde, si su entrada fina correspondiente queda fuera de la grilla fina o si dicha entrada es fija.
+		for(int I=0; I < coarse.rows; ++I){
+			for(int J=0; J < coarse.columns; ++J){
+				bool border = (I == 0 || J == 0 || I == coarse.rows-1 || J == coarse.columns-1);
+				bool outside = (2*I >= prev.rows || 2*J >= prev.columns);
+				coarse.fixed[I*coarse.columns + J] = (border || outside || prev.fixed[(2*I)*prev.columns + 2*J]);
+			}
+		}
+		galerkin(prev, coarse);
+		levels.push_back(coarse);
+	}
+	return levels;
+}
+
+// Barrido de Gauss-Seidel/SOR sobre un nivel, empleado como suavizador.
+// En el nivel 0 es la misma actualización de 'gauss_seidel_redblack', incorporando el término fuente: u = (1+omega)/4*(vecinos + f) - omega*u.
+// En los niveles gruesos la matriz de Galerkin acopla también a los vecinos diagonales, por lo que el ordenamiento rojo-negro deja de ser independiente. En este caso se emplean cuatro colores según la paridad de la fila y de la columna.
+// Regresa la mayor diferencia entre el valor nuevo y el anterior.
+double smooth(Level& level, double omega){
+	int column = level.columns;
+	double maxDelta = 0.0;
+	bool five_point = level.stencil.empty();
+	int colors = five_point ? 2 : 4;
+	for(int color=0; color < colors; ++color){
+		#pragma omp parallel for schedule(static) reduction(max:maxDelta)
+		for(int i=1; i < level.rows-1; ++i){
+			int jStart;
+			if(five_point){
+				jStart = 1 + (i+1+color)%2;
+			} else{
+				// El color (i%2, j%2) se codifica como 2*(i%2) + j%2.
+				if(i%2 != color/2){
+					continue;
+				}
+				jStart = (color%2 == 1) ? 1 : 2;
+			}
+			for(int j=jStart; j < column-1; j += 2){
+				if(level.fixed[i*column + j]){
+					continue;
+				}
+				double new_value;
+				if(five_point){
+					new_value = ((1.0+omega)*0.25)*(level.u[(i+1)*column + j] + level.u[(i-1)*column + j] + level.u[i*column + (j+1)] + level.u[i*column + (j-1)] + level.f[i*column + j]) - omega*level.u[i*column + j];
+				} else{
+					const double* a = &level.stencil[(i*column + j)*9];
+					double sum = level.f[i*column + j];
+					for(int k=0; k < 9; ++k){
+						if(k != 4){
+							sum -= a[k]*level.u[(i+k/3-1)*column + (j+k%3-1)];
+						}
+					}
+					new_value = (1.0+omega)*sum/a[4] - omega*level.u[i*column + j];
+				}
+				maxDelta = std::max(maxDelta, std::abs(new_value - level.u[i*column + j]));
+				level.u[i*column + j] = new_value;
+			}
+		}
+	}
+	return maxDelta;
+}
+
+// Cálculo del residuo r = f - A*u. El residuo es nulo en las entradas fijas.
+void residual(Level& level){
+	int column = level.columns;
+	#pragma omp parallel for schedule(static)
+	for(int i=1; i < level.rows-1; ++i){
+		for(int j=1; j < column-1; ++j){
+			if(level.fixed[i*column + j]){
+				level.r[i*column + j] = 0.0;
+			} else if(level.stencil.empty()){
+				level.r[i*column + j] = level.f[i*column + j] - (4.0*level.u[i*column + j] - level.u[(i+1)*column + j] - level.u[(i-1)*column + j] - level.u[i*column + (j+1)] - level.u[i*column + (j-1)]);
+			} else{
+				const double* a = &level.stencil[(i*column + j)*9];
+				double sum = level.f[i*column + j];
+				for(int k=0; k < 9; ++k){
+					sum -= a[k]*level.u[(i+k/3-1)*column + (j+k%3-1)];
+				}
+				level.r[i*column + j] = sum;
+			}
+		}
+	}
+}
+
+// Restricción del residuo del nivel fino al término fuente del nivel grueso mediante ponderación completa (full weighting), R = P^T/4.
+// Las entradas finas fuera de la grilla se consideran nulas.
+void restrict_residual(const Level& fine, Level& coarse){
+	#pragma omp parallel for schedule(static)
+	for(int I=1; I < coarse.rows-1; ++I){
+		for(int J=1; J < coarse.columns-1; ++J){
+			double sum = 0.0;
+			if(!coarse.fixed[I*coarse.columns + J]){
+				for(int di=-1; di <= 1; ++di){
+					for(int dj=-1; dj <= 1; ++dj){
+						int i = 2*I+di;
+						int j = 2*J+dj;
+						if(i < fine.rows && j < fine.columns){
+							// Pesos 4, 2 y 1 para la entrada central, las vecinas directas y las diagonales, respectivamente.
+							sum += (2-std::abs(di))*(2-std::abs(dj))*fine.r[i*fine.columns + j];
+						}
+					}
+				}
+			}
+			coarse.f[I*coarse.columns + J] = sum/16.0;
+		}
+	}
+}
+
+// Interpolación bilineal de la corrección del nivel grueso, sumándola a las entradas libres del nivel fino.
+void prolong_correction(const Level& coarse, Level& fine){
+	#pragma omp parallel for schedule(static)
+	for(int i=1; i < fine.rows-1; ++i){
+		for(int j=1; j < fine.columns-1; ++j){
+			if(fine.fixed[i*fine.columns + j]){
+				continue;
+			}
+			int I = i/2;
+			int J = j/2;
+			// Para índices impares se promedian las dos entradas gruesas vecinas en esa dirección.
+			int I2 = I + i%2;
+			int J2 = J + j%2;
+			fine.u[i*fine.columns + j] += 0.25*(coarse.u[I*coarse.columns + J] + coarse.u[I*coarse.columns + J2] + coarse.u[I2*coarse.columns + J] + coarse.u[I2*coarse.columns + J2]);
+		}
+	}
+}
+
+// Ciclo V recursivo a partir del nivel 'l'. Se realizan 'nu' barridos de suavizado antes y después de la corrección del nivel grueso.
+// En el nivel más grueso se realizan barridos hasta que la diferencia sea despreciable.
+void v_cycle(std::vector<Level>& levels, int l, double omega, int nu){
+	Level& level = levels[l];
+	if(l == (int)levels.size()-1){
+		for(int k=0; k < 1000; ++k){
+			if(smooth(level, omega) < 1e-14){
+				break;
+			}
+		}
+		return;
+	}
+	for(int k=0; k < nu; ++k){
+		smooth(level, omega);
+	}
+	residual(level);
+	Level& coarse = levels[l+1];
+	restrict_residual(level, coarse);
+	// La corrección inicial es nula, incluyendo las entradas fijas (condiciones de Dirichlet homogéneas).
+	std::fill(coarse.u.begin(), coarse.u.end(), 0.0);
+	v_cycle(levels, l+1, omega, nu);
+	prolong_correction(coarse, level);
+	for(int k=0; k < nu; ++k){
+		smooth(level, omega);
+	}
+}
+
+// Función que resuelve el problema del capacitor mediante multigrid geométrico, paralelizando cada operación sobre la grilla con OpenMP.
+// Los argumentos son los mismos que en 'gauss_seidel'; en este caso 'omega' corresponde al parámetro del suavizador (omega = 0 equivale a Gauss-Seidel).
+// Si 'fmg' es verdadero, se emplea multigrid completo (Full Multigrid): se resuelve primero en el nivel más grueso y se interpola la solución como valor inicial de cada nivel más fino, seguido de un ciclo V por nivel.
+// La convergencia se evalúa con la mayor diferencia de la grilla entre dos ciclos V consecutivos. Regresa el número de ciclos V realizados en el nivel 0.
+int multigrid(GridVector& phi, double omega, int factor, double tolerance, bool fmg = false){
+
+	if(phi.size() != (size_t)(10*factor)*(10*factor+1)){
+		std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+		exit(1);
+	}
+
+	if(tolerance <= 0){
+		std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+		exit(1);
+		}
+
+	double time_1 = seconds();
+	std::vector<Level> levels = build_levels(phi, factor);
+	int L = levels.size();
+	// Número de barridos de suavizado antes y después de cada corrección.
+	int nu = 2;
+	int its = 0;
+
+	if(fmg){
+		// El término fuente de cada nivel grueso es la restricción del residuo de la grilla inicial, el cual contiene la contribución de las líneas de potencial.
+		residual(levels[0]);
+		for(int l=1; l < L; ++l){
+			restrict_residual(levels[l-1], levels[l]);
+			levels[l].r = levels[l].f;
+		}
+		v_cycle(levels, L-1, omega, nu);
+		// Se interpola la solución de cada nivel como valor inicial del siguiente nivel fino, seguido de un ciclo V.
+		for(int l=L-2; l >= 0; --l){
+			prolong_correction(levels[l+1], levels[l]);
+			v_cycle(levels, l, omega, nu);
+		}
+		its += 1;
+	}
+
+	// Copia de la solución al inicio de cada ciclo, para evaluar la diferencia entre ciclos. Su costo es pequeño frente al de un ciclo V completo.
+	GridVector previous;
+	double delta = 1.0;
+	while(delta > tolerance){
+		{
+		TELEMETRY_SCOPE(PHASE_SWEEP);
+		previous = levels[0].u;
+		v_cycle(levels, 0, omega, nu);
+		}
+		{
+		TELEMETRY_SCOPE(PHASE_CHECK);
+		delta = 0.0;
+		#pragma omp parallel for schedule(static) reduction(max:delta)
+		for(size_t k=0; k < previous.size(); ++k){
+			delta = std::max(delta, std::abs(levels[0].u[k] - previous[k]));
+		}
+		}
+		its += 1;
+		TELEMETRY_ITERATION(its, delta);
+	}
+
+	double time_2 = seconds();
+	phi = levels[0].u;
+	std::cout << "Número de procesos: " << omp_get_max_threads() << std::endl;
+	std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+	std::cout << "Niveles de multigrid: " << L << std::endl;
+	std::cout << "Diferencia máxima: " << delta << std::endl;
+	return its;
+}
+
+// Gradiente conjugado precondicionado (PCG) sin matriz explícita.
+// Se resuelve A*x = b sobre las entradas libres, donde A es el laplaciano de cinco puntos (4 en la diagonal y -1 con cada vecina libre) y b contiene las contribuciones de las líneas de potencial y los bordes. La matriz es simétrica y definida positiva.
+// Todos los vectores tienen la misma disposición que la grilla de 'grid_generator' y son nulos en las entradas fijas, por lo que A se aplica con el mismo stencil de las demás variantes.
+
+// Aplicación del operador: y = A*x en las entradas libres y 0 en las fijas. Regresa el producto punto x·y, que el método requiere inmediatamente después.
+// Si 'x' contiene los valores fijos de la grilla, -y es el residuo b - A*x.
+double apply_operator(const std::vector<char>& fixed, const GridVector& x, GridVector& y, int factor){
+	int column = 10*factor+1;
+	double dot = 0.0;
+	#pragma omp parallel for schedule(static) reduction(+:dot)
+	for(int i=1; i < 10*factor-1; ++i){
+		for(int j=1; j < column-1; ++j){
+			int k = i*column + j;
+			y[k] = fixed[k] ? 0.0 : 4.0*x[k] - x[k+1] - x[k-1] - x[k+column] - x[k-column];
+			dot += x[k]*y[k];
+		}
+	}
+	return dot;
+}
+
+// Producto punto paralelo.
+double dot_product(const GridVector& x, const GridVector& y){
+	double dot = 0.0;
+	#pragma omp parallel for schedule(static) reduction(+:dot)
+	for(size_t k=0; k < x.size(); ++k){
+		dot += x[k]*y[k];
+	}
+	return dot;
+}
+
+// Precondicionador SSOR: una iteración simétrica de SOR rojo-negro (rojo, negro, rojo) sobre A*z = r a partir de z = 0.
+// La secuencia de colores es un palíndromo, por lo que el precondicionador resultante es simétrico; cada media iteración se paraleliza igual que en 'gauss_seidel_redblack'.
+void ssor_preconditioner(const std::vector<char>& fixed, const GridVector& r, GridVector& z, double omega, int factor){
+	int column = 10*factor+1;
+	std::fill(z.begin(), z.end(), 0.0);
+	const int colors[3] = {0, 1, 0};
+	for(int color : colors){
+		#pragma omp parallel for schedule(static)
+		for(int i=1; i < 10*factor-1; ++i){
+			for(int j=1 + (i+1+color)%2; j < column-1; j += 2){
+				int k = i*column + j;
+				if(!fixed[k]){
+					z[k] = ((1.0+omega)*0.25)*(z[k+1] + z[k-1] + z[k+column] + z[k-column] + r[k]) - omega*z[k];
+				}
+			}
+		}
+	}
+}
+
+// Función que resuelve el problema del capacitor mediante gradiente conjugado precondicionado, paralelizando la aplicación del operador, los productos punto y el precondicionador con OpenMP.
+// El argumento 'preconditioner' escoge el precondicionador: 'jacobi' (z = r/4), 'ssor' (ver 'ssor_preconditioner'), 'multigrid' (un ciclo V de 'v_cycle' con la jerarquía de 'build_levels') o 'ninguno'.
+// Como la diagonal de A es constante, el precondicionador de Jacobi sólo escala el residuo y realiza las mismas iteraciones que 'ninguno'; se incluye como referencia.
+// 'omega' es el parámetro de SSOR y del suavizador del ciclo V. Con el ordenamiento rojo-negro el mejor valor es omega = 0 (Gauss-Seidel simétrico), igual que en 'multigrid'.
+// El ciclo V con suavizado rojo-negro antes y después de la corrección no es exactamente simétrico, por lo que se emplea la fórmula de Polak-Ribière para beta, que tolera precondicionadores ligeramente variables.
+// La convergencia se evalúa con el mayor residuo de la grilla. Regresa el número de iteraciones.
+int conjugate_gradient(GridVector& phi, double omega, int factor, double tolerance, const std::string& preconditioner = "multigrid"){
+
+	if(phi.size() != (size_t)(10*factor)*(10*factor+1)){
+		std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+		exit(1);
+	}
+
+	if(tolerance <= 0){
+		std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+		exit(1);
+		}
+
+	if(preconditioner != "jacobi" && preconditioner != "ssor" && preconditioner != "multigrid" && preconditioner != "ninguno"){
+		std::cerr << "Precondicionador no reconocido: " << preconditioner << ". Las opciones son 'jacobi', 'ssor', 'multigrid' y 'ninguno'." << std::endl;
+		exit(1);
+	}
+
+	double time_1 = seconds();
+	size_t n = phi.size();
+	// La jerarquía de multigrid también provee la máscara de entradas fijas. La solución del nivel 0 se reemplaza en cada aplicación del precondicionador.
+	std::vector<Level> levels = build_levels(GridVector(n, 0.0), factor);
+	if(preconditioner != "multigrid"){
+		levels.resize(1);
+	}
+	const std::vector<char>& fixed = levels[0].fixed;
+	int nu = 2;
+
+	// Los vectores de trabajo se escriben por primera vez en paralelo ('GridVector', ver 'grid2d.h').
+	GridVector r(n, 0.0), z(n, 0.0), p(n, 0.0), q(n, 0.0), r_old(n, 0.0);
+	auto precondition = [&](){
+		if(preconditioner == "jacobi"){
+			#pragma omp parallel for schedule(static)
+			for(size_t k=0; k < n; ++k){
+				z[k] = 0.25*r[k];
+			}
+		} else if(preconditioner == "ssor"){
+			ssor_preconditioner(fixed, r, z, omega, factor);
+		} else if(preconditioner == "multigrid"){
+			std::fill(levels[0].u.begin(), levels[0].u.end(), 0.0);
+			levels[0].f = r;
+			v_cycle(levels, 0, omega, nu);
+			z = levels[0].u;
+		} else{
+			z = r;
+		}
+	};
+
+	// Residuo inicial r = b - A*phi.
+	apply_operator(fixed, phi, r, factor);
+	double maxResidual = 0.0;
+	#pragma omp parallel for schedule(static) reduction(max:maxResidual)
+	for(size_t k=0; k < n; ++k){
+		r[k] = -r[k];
+		maxResidual = std::max(maxResidual, std::abs(r[k]));
+	}
+	precondition();
+	p = z;
+	double rz = dot_product(r, z);
+
+	int its = 0;
+	while(maxResidual > tolerance){
+		double alpha = rz/apply_operator(fixed, p, q, factor);
+		maxResidual = 0.0;
+		#pragma omp parallel for schedule(static) reduction(max:maxResidual)
+		for(size_t k=0; k < n; ++k){
+			phi[k] += alpha*p[k];
+			r_old[k] = r[k];
+			r[k] -= alpha*q[k];
+			maxResidual = std::max(maxResidual, std::abs(r[k]));
+		}
+		its++;
+		if(maxResidual <= tolerance){
+			break;
+		}
+		if(maxResidual > 1e10){
+			std::cerr << "WARNING: Residual is increasing uncontrollably, consider changing the preconditioner." << std::endl;
+			break;
+		}
+		precondition();
+		double rz_new = dot_product(r, z);
+		double beta = (rz_new - dot_product(r_old, z))/rz;
+		rz = rz_new;
+		#pragma omp parallel for schedule(static)
+		for(size_t k=0; k < n; ++k){
+			p[k] = z[k] + beta*p[k];
+		}
+	}
+
+	double time_2 = seconds();
+	std::cout << "Número de procesos: " << omp_get_max_threads() << std::endl;
+	std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+	std::cout << "Precondicionador: " << preconditioner << std::endl;
+	std::cout << "Residuo máximo: " << maxResidual << std::endl;
+	return its;
 }
-int main(){
+
+// Barridos de voltaje por superposición.
+// El problema es lineal en los voltajes de las líneas de potencial (los bordes son nulos), por lo que la solución con (V1, V2) es V1*phi1 + V2*phi2, donde phi1 y phi2 son las soluciones con (1, 0) y (0, 1).
+// Las soluciones base se calculan una sola vez por método y factor de escala y se guardan en archivos con el formato de 'checkpoint.h' ('PREFIJO_<método>_f<factor>_<k>.bin'), que se reutilizan mientras su tolerancia
+// no sea mayor a la solicitada. El método forma parte del nombre porque la tolerancia no significa lo mismo en todos: los métodos de sobre-relajación se detienen con la diferencia máxima entre iteraciones,
+// y multigrid y gradiente conjugado con el residuo.
+// El error de cada combinación es a lo sumo |V1|*e1 + |V2|*e2, con e1 y e2 los errores de las soluciones base.
+
+// Lista de pares de voltaje: un par 'V1 V2' por línea; se omiten las líneas vacías y las que inician con '#'.
+std::vector<std::pair<double, double>> read_voltages(const std::string& path){
+	std::ifstream in(path);
+	if(!in){
+		std::cerr << "No se pudo abrir la lista de voltajes: " << path << std::endl;
+		exit(1);
+	}
+	std::vector<std::pair<double, double>> voltages;
+	std::string line;
+	while(std::getline(in, line)){
+		std::istringstream fields(line);
+		double V1, V2;
+		if(line.empty() || line[0] == '#'){
+			continue;
+		}
+		if(!(fields >> V1 >> V2)){
+			std::cerr << "Línea no válida en la lista de voltajes: " << line << std::endl;
+			exit(1);
+		}
+		voltages.push_back({V1, V2});
+	}
+	if(voltages.empty()){
+		std::cerr << "La lista de voltajes está vacía!" << std::endl;
+		exit(1);
+	}
+	return voltages;
+}
+
+// Solución base 'k' (1: V1 = 1, V2 = 0; 2: V1 = 0, V2 = 1), desde el caché o resolviéndola con 'solve' y guardándola. 'method' y 'omega' son el método de 'solve' y su parámetro de relajación.
+// Regresa el tiempo de solución, o cero si proviene del caché.
+double basis_solution(int k, int factor, double tolerance, const std::string& method, double omega, const std::string& prefix, const std::function<int(GridVector&)>& solve, GridVector& basis){
+	std::string path = prefix + "_" + method + "_f" + std::to_string(factor) + "_" + std::to_string(k) + ".bin";
+	GridHeader header;
+	if(read_grid_file(path, header, basis) && header.factor == factor && header.tolerance > 0 && header.tolerance <= tolerance){
+		std::cerr << "Solución base " << k << ": " << path << " (tolerancia " << header.tolerance << ")" << std::endl;
+		return 0.0;
+	}
+	basis = grid_generator(factor, k == 1 ? 1.0 : 0.0, k == 2 ? 1.0 : 0.0);
+	double time_1 = seconds();
+	int its = solve(basis);
+	double time_2 = seconds();
+	header.rows = 10*factor;
+	header.columns = 10*factor+1;
+	header.factor = factor;
+	header.iterations = its;
+	header.V1 = (k == 1) ? 1.0 : 0.0;
+	header.V2 = (k == 2) ? 1.0 : 0.0;
+	header.omega = omega;
+	header.tolerance = tolerance;
+	write_grid_file(path, header, basis);
+	std::cerr << "Solución base " << k << ": " << its << " iteraciones, guardada en " << path << std::endl;
+	return time_2 - time_1;
+}
+
+// Combinación lineal 'phi = V1*phi1 + V2*phi2', repartida entre los hilos y vectorizada.
+void superpose(const GridVector& phi1, const GridVector& phi2, double V1, double V2, GridVector& phi){
+	const double* a = phi1.data();
+	const double* b = phi2.data();
+	double* out = phi.data();
+	long n = phi.size();
+	#pragma omp parallel for simd schedule(static)
+	for(long k=0; k < n; ++k){
+		out[k] = V1*a[k] + V2*b[k];
+	}
+}
+
+// Barrido de los pares de voltaje de 'path'. Las grillas se calculan una a la vez sobre el mismo búfer y se escriben de inmediato en 'output' (un arreglo '.npy' de forma (pares, filas, columnas)); sin archivo sólo se reporta el tiempo.
+// Como referencia se resuelve directamente el primer par con 'solve', lo que permite reportar la diferencia con la superposición y el speedup respecto de resolver cada par por separado.
+void voltage_sweep(const std::string& path, int factor, double tolerance, const std::string& method, double omega, const std::string& prefix, const std::string& output,
+                   const std::function<int(GridVector&)>& solve){
+	std::vector<std::pair<double, double>> voltages = read_voltages(path);
+	int rows = 10*factor;
+	int column = 10*factor+1;
+	std::FILE* file = NULL;
+	if(!output.empty()){
+		if(output.size() < 4 || output.compare(output.size()-4, 4, ".npy") != 0){
+			std::cerr << "La salida del barrido de voltajes debe ser un archivo '.npy'!" << std::endl;
+			exit(1);
+		}
+		file = std::fopen(output.c_str(), "wb");
+		if(file == NULL){
+			std::cerr << "No se pudo abrir el archivo de salida: " << output << std::endl;
+			exit(1);
+		}
+	}
+
+	GridVector phi1, phi2;
+	double basis_time = basis_solution(1, factor, tolerance, method, omega, prefix, solve, phi1);
+	basis_time += basis_solution(2, factor, tolerance, method, omega, prefix, solve, phi2);
+
+	GridVector direct = grid_generator(factor, voltages[0].first, voltages[0].second);
+	double time_1 = seconds();
+	solve(direct);
+	double direct_time = seconds() - time_1;
+
+	GridVector phi(phi1.size());
+	double difference = 0.0;
+	time_1 = seconds();
+	if(file != NULL){
+		write_npy_header(file, "(" + std::to_string(voltages.size()) + ", " + std::to_string(rows) + ", " + std::to_string(column) + ")");
+	}
+	for(size_t p=0; p < voltages.size(); ++p){
+		superpose(phi1, phi2, voltages[p].first, voltages[p].second, phi);
+		if(p == 0){
+			for(size_t k=0; k < phi.size(); ++k){
+				difference = std::max(difference, std::abs(phi[k] - direct[k]));
+			}
+		}
+		if(file != NULL){
+			std::fwrite(phi.data(), sizeof(double), phi.size(), file);
+		}
+	}
+	if(file != NULL && std::fclose(file) != 0){
+		std::cerr << "Error al escribir el archivo de salida: " << output << std::endl;
+		exit(1);
+	}
+	double sweep_time = seconds() - time_1;
+
+	std::cout << "Pares de voltaje: " << voltages.size() << std::endl;
+	std::cout << "Tiempo de las soluciones base: " << basis_time << std::endl;
+	std::cout << "Tiempo de una solución directa: " << direct_time << std::endl;
+	std::cout << "Tiempo del barrido: " << sweep_time << "; Tiempo por par: " << sweep_time/voltages.size() << std::endl;
+	std::cout << "Diferencia con la solución directa del primer par: " << difference << std::endl;
+	std::cout << "Speedup respecto de soluciones independientes: " << voltages.size()*direct_time/(basis_time + sweep_time) << std::endl;
+}
+
+// Impresión de la grilla con 'grid_output.h': CSV en la salida estándar por defecto, o en el archivo 'path' ('.npy' para el formato binario de numpy).
+void print_grid(GridVector &matrix, int factor, int precision = 4, const std::string& path = ""){
+  write_grid(path, matrix, 10*factor, 10*factor+1, precision);
+}
+// El método de iteración se escoge desde la terminal: './a.out' o './a.out wavefront' para el método de wavefront, './a.out redblack' para el ordenamiento rojo-negro, './a.out simd' para el kernel vectorizado rojo-negro, './a.out tiled' para el wavefront de bloques, './a.out multigrid' para ciclos V, './a.out fmg' para multigrid completo y './a.out pcg' para gradiente conjugado precondicionado.
+// Opciones adicionales:
+//   '--chequeo N' evalúa la convergencia de Gauss-Seidel únicamente cada N iteraciones.
+//   '--bloque N' cambia el tamaño de los bloques del método 'tiled'.
+//   '--kernel K' escoge el conjunto de instrucciones del método 'simd': 'auto', 'avx512', 'avx2' o 'scalar'.
+//   '--simetria S' resuelve el método 'simd' sobre un dominio reducido por simetría y reconstruye la grilla completa ('symmetry.h'): 'mitad', 'cuarto' (requiere V1 = -V2 o V1 = V2), 'auto' o 'ninguna' (por defecto).
+//   '--bloque-temporal T' aplica en el método 'simd' T iteraciones consecutivas a cada bloque de filas en caché, con un frente de onda de bloques entre hilos ('temporal_blocking.h').
+//   '--incremental' barre en el método 'simd' únicamente los bloques que aún cambian y sus vecinos, con barridos completos de verificación ('active_tiles.h'); también es el método 'simd_incremental'.
+//     '--incremental-filas N', '--incremental-columnas N', '--verificacion N' y '--umbral U' tienen el mismo significado que en la versión serial. Con '--comparar' se reportan la fracción de bloques omitidos y el ahorro de tiempo de 'simd_incremental' frente a 'simd' con el mismo omega (menor tiempo de ACTIVE_COMPARE_REPEATS ejecuciones de cada modo).
+//   '--factor N' cambia el factor de escala de la grilla.
+//   '--tolerancia T' cambia la tolerancia de convergencia.
+//   '--comparar' ejecuta todos los métodos y reporta iteraciones y tiempo de cada uno.
+//   '--salida ARCHIVO' escribe la grilla resultante: '.npy' para el formato binario de numpy o CSV con cualquier otra extensión. Con '--comparar' se escribe la grilla del último método.
+//   '--precision P' cambia las cifras significativas del CSV (4 por defecto).
+//   '--omega W' cambia el parámetro de sobre-relajación de Gauss-Seidel; con '--omega auto' se escoge el óptimo estimado en 'omega_tuning.h' (guardado en 'omega_cache.dat').
+//     Junto con '--comparar', los métodos de sobre-relajación se ejecutan también con el omega fijo por defecto para reportar el ahorro de iteraciones.
+//   '--precondicionador P' escoge el precondicionador del método 'pcg': 'multigrid' (por defecto), 'ssor', 'jacobi' o 'ninguno'.
+//   '--respaldo ARCHIVO' escribe un punto de control de la grilla cada 100 iteraciones (o cada N con '--respaldo-cada N') y al finalizar, en el formato binario de 'checkpoint.h'.
+//   '--reanudar' continúa desde el punto de control de '--respaldo' si existe; de lo contrario inicia desde cero.
+//   '--inicial ARCHIVO' interpola como valor inicial una solución de otro factor de escala (un punto de control o la salida '.bin' de la versión distribuida).
+//     Los puntos de control y el valor inicial están disponibles en los métodos 'wavefront' y 'redblack'.
+//   '--barrido ARCHIVO' resuelve todos los pares de voltaje del archivo (un par 'V1 V2' por línea) por superposición de las soluciones base del método escogido (ver 'voltage_sweep').
+//     Las soluciones base se guardan en 'capacitor_base_<método>_f<factor>_<k>.bin' ('--base PREFIJO' cambia el prefijo) y la salida, con '--salida', debe ser un archivo '.npy'.
+//   '--paginas-grandes' reserva la grilla rellena del método 'simd' con páginas grandes transparentes (ver 'grid2d.h').
+//   '--telemetria ARCHIVO' escribe una línea JSON por iteración con el residuo y el tiempo de cada fase ('-' para la salida de error); '--contadores' agrega los contadores de hardware del hilo maestro.
+//     Requiere compilar con '-DCAPACITOR_TELEMETRY' (ver 'telemetry.h'); en los métodos 'multigrid' y 'fmg' cada línea corresponde a un ciclo. No está disponible en 'pcg'.
+//   '--benchmark' reporta además la cantidad de iteraciones del método (ver 'src/benchmark').
+int main(int argc, char* argv[]){
   int factor = 50;
   double volt1 = 1.0;
   double volt2 = -1.0;
-  std::vector<double> grid = grid_generator(factor, volt1, volt2);
-  double omega = 0.9;
+  const double fixed_omega = 0.9;
+  double omega = fixed_omega;
+  // Parámetro del suavizador de multigrid. Gauss-Seidel (omega = 0) es un mejor suavizador que la sobre-relajación.
+  double mg_omega = 0.0;
   double tolerance = 1e-4;
-  int iterations = gauss_seidel(grid, omega, factor, tolerance);
-  //print_grid(grid, factor);
+  std::string method = "wavefront";
+  int check_every = 1;
+  int tile = 64;
+  int depth = 1;
+  std::string symmetry_option = "ninguna";
+  ActiveTileSettings active;
+  std::string kernel = "auto";
+  bool compare = false;
+  std::string output = "";
+  int precision = 4;
+  bool benchmark = false;
+  std::string preconditioner = "multigrid";
+  CheckpointSettings checkpoint;
+  std::string voltages = "";
+  std::string basis_prefix = "capacitor_base";
+  bool huge_pages = false;
+  std::string telemetry_path = "";
+  bool counters = false;
+  for(int a = 1; a < argc; ++a){
+    std::string arg = argv[a];
+    if(arg == "--chequeo" && a+1 < argc){
+      check_every = std::stoi(argv[++a]);
+    } else if(arg == "--bloque" && a+1 < argc){
+      tile = std::stoi(argv[++a]);
+    } else if(arg == "--kernel" && a+1 < argc){
+      kernel = argv[++a];
+    } else if(arg == "--bloque-temporal" && a+1 < argc){
+      depth = std::stoi(argv[++a]);
+    } else if(arg == "--simetria" && a+1 < argc){
+      symmetry_option = argv[++a];
+    } else if(arg == "--incremental"){
+      active.enabled = true;
+    } else if(arg == "--incremental-filas" && a+1 < argc){
+      active.tileRows = std::stoi(argv[++a]);
+    } else if(arg == "--incremental-columnas" && a+1 < argc){
+      active.tileColumns = std::stoi(argv[++a]);
+    } else if(arg == "--verificacion" && a+1 < argc){
+      active.verify_every = std::stoi(argv[++a]);
+    } else if(arg == "--umbral" && a+1 < argc){
+      active.threshold = std::stod(argv[++a]);
+    } else if(arg == "--factor" && a+1 < argc){
+      factor = std::stoi(argv[++a]);
+    } else if(arg == "--tolerancia" && a+1 < argc){
+      tolerance = std::stod(argv[++a]);
+    } else if(arg == "--comparar"){
+      compare = true;
+    } else if(arg == "--salida" && a+1 < argc){
+      output = argv[++a];
+    } else if(arg == "--precision" && a+1 < argc){
+      precision = std::stoi(argv[++a]);
+    } else if(arg == "--omega" && a+1 < argc){
+      omega = parse_omega(argv[++a]);
+    } else if(arg == "--precondicionador" && a+1 < argc){
+      preconditioner = argv[++a];
+    } else if(arg == "--respaldo" && a+1 < argc){
+      checkpoint.path = argv[++a];
+    } else if(arg == "--respaldo-cada" && a+1 < argc){
+      checkpoint.every = std::stoi(argv[++a]);
+    } else if(arg == "--reanudar"){
+      checkpoint.resume = true;
+    } else if(arg == "--inicial" && a+1 < argc){
+      checkpoint.initial = argv[++a];
+    } else if(arg == "--barrido" && a+1 < argc){
+      voltages = argv[++a];
+    } else if(arg == "--base" && a+1 < argc){
+      basis_prefix = argv[++a];
+    } else if(arg == "--paginas-grandes"){
+      huge_pages = true;
+    } else if(arg == "--telemetria" && a+1 < argc){
+      telemetry_path = argv[++a];
+    } else if(arg == "--contadores"){
+      counters = true;
+    } else if(arg == "--benchmark"){
+      benchmark = true;
+    } else{
+      method = arg;
+    }
+  }
+
+  bool restart = !checkpoint.path.empty() || checkpoint.resume || !checkpoint.initial.empty();
+  if(restart && (compare || (method != "wavefront" && method != "redblack"))){
+    std::cerr << "Los puntos de control y el valor inicial sólo están disponibles en los métodos 'wavefront' y 'redblack'!" << std::endl;
+    exit(1);
+  }
+  if(checkpoint.every < 1){
+    std::cerr << "La frecuencia de los puntos de control debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+  }
+  if(checkpoint.resume && checkpoint.path.empty()){
+    std::cerr << "La opción '--reanudar' requiere el archivo del punto de control ('--respaldo')!" << std::endl;
+    exit(1);
+  }
+
+  if(!voltages.empty() && (compare || restart)){
+    std::cerr << "El barrido de voltajes no está disponible junto con '--comparar' ni con los puntos de control!" << std::endl;
+    exit(1);
+  }
+
+  check_active_settings(active);
+  if(method == "simd_incremental"){
+    method = "simd";
+    active.enabled = true;
+  }
+  if(active.enabled && !compare && method != "simd"){
+    std::cerr << "El modo incremental sólo está disponible en el método 'simd'!" << std::endl;
+    exit(1);
+  }
+  ActiveTileSettings incremental = active;
+  incremental.enabled = true;
+
+  SymmetryDomain symmetry = symmetry_domain(symmetry_option, factor, volt1, volt2);
+  if(symmetry.mode != SYMMETRY_NONE && (compare || method != "simd" || !voltages.empty())){
+    std::cerr << "El dominio reducido por simetría sólo está disponible en el método 'simd', sin '--comparar' ni '--barrido'!" << std::endl;
+    exit(1);
+  }
+
+  bool automatic = (omega == AUTO_OMEGA);
+  if(automatic){
+    omega = auto_omega(factor);
+  }
+
+  if(!telemetry_path.empty()){
+    if(compare || !voltages.empty()){
+      std::cerr << "La telemetría registra una única ejecución, por lo que no está disponible con '--comparar' ni con '--barrido'!" << std::endl;
+      exit(1);
+    }
+    telemetry_open(telemetry_path, counters);
+  }
+
+  // Ejecución del método 'm' sobre la grilla, con el parámetro de sobre-relajación 'w'. 'skipped' recibe la fracción de bloques omitidos de 'simd_incremental'.
+  double skipped = 0.0;
+  auto solve = [&](GridVector& grid, const std::string& m, double w){
+    if(m == "wavefront"){
+      return gauss_seidel(grid, w, factor, tolerance, check_every, checkpoint);
+    } else if(m == "redblack"){
+      return gauss_seidel_redblack(grid, w, factor, tolerance, check_every, checkpoint);
+    } else if(m == "simd"){
+      return gauss_seidel_simd(grid, w, factor, tolerance, check_every, kernel, huge_pages, depth, symmetry, compare ? ActiveTileSettings() : active);
+    } else if(m == "simd_incremental"){
+      // Sólo se llega aquí con '--comparar': el modo incremental escoge los bloques en cada iteración, por lo que no emplea el bloque temporal ni '--chequeo'.
+      return gauss_seidel_simd(grid, w, factor, tolerance, 1, kernel, huge_pages, 1, symmetry, incremental, &skipped);
+    } else if(m == "tiled"){
+      return gauss_seidel_tiled(grid, w, factor, tolerance, check_every, tile);
+    } else if(m == "multigrid" || m == "fmg"){
+      return multigrid(grid, mg_omega, factor, tolerance, m == "fmg");
+    } else if(m == "pcg"){
+      return conjugate_gradient(grid, mg_omega, factor, tolerance, preconditioner);
+    }
+    std::cerr << "Método no reconocido: " << m << ". Las opciones son 'wavefront', 'redblack', 'simd', 'simd_incremental', 'tiled', 'multigrid', 'fmg' y 'pcg'." << std::endl;
+    exit(1);
+  };
+
+  if(!voltages.empty()){
+    bool sor = (method != "multigrid" && method != "fmg" && method != "pcg");
+    voltage_sweep(voltages, factor, tolerance, method, sor ? omega : mg_omega, basis_prefix, output, [&](GridVector& grid){ return solve(grid, method, omega); });
+    return 0;
+  }
+
+  std::vector<std::string> methods = {method};
+  if(compare){
+    methods = {"wavefront", "redblack", "simd", "simd_incremental", "tiled", "multigrid", "fmg", "pcg"};
+  }
+  // Tiempo de 'simd' para cada omega, con el que se compara el modo incremental.
+  std::map<double, double> simd_time;
+  for(const std::string& m : methods){
+    bool sor = (m != "multigrid" && m != "fmg" && m != "pcg");
+    // Con omega automático, cada método de sobre-relajación se ejecuta primero con el omega fijo como referencia.
+    std::vector<double> omegas = {omega};
+    if(compare && automatic && sor){
+      omegas = {fixed_omega, omega};
+    }
+    // Con '--comparar', 'simd' y 'simd_incremental' se repiten y se toma el menor tiempo de cada uno, de modo que ambos se comparan con la caché y la memoria en el mismo estado.
+    int repeats = (compare && (m == "simd" || m == "simd_incremental")) ? ACTIVE_COMPARE_REPEATS : 1;
+    int fixed_iterations = 0;
+    for(size_t r=0; r < omegas.size(); ++r){
+      GridVector grid;
+      int iterations = 0;
+      double elapsed = 0.0;
+      for(int repeat=0; repeat < repeats; ++repeat){
+        grid = grid_generator(factor, volt1, volt2);
+        load_initial_state(checkpoint, grid, factor, volt1, volt2);
+        double time_1 = seconds();
+        iterations = solve(grid, m, omegas[r]);
+        double time_2 = seconds();
+        elapsed = (repeat == 0) ? time_2 - time_1 : std::min(elapsed, time_2 - time_1);
+        TELEMETRY_FINISH();
+      }
+      if(m == "simd"){
+        simd_time[omegas[r]] = elapsed;
+      }
+      if(compare){
+        std::cout << "Método: " << m;
+        if(omegas.size() > 1){
+          std::cout << "; Omega: " << omegas[r];
+        }
+        std::cout << "; Iteraciones: " << iterations;
+        if(repeats > 1){
+          std::cout << "; Tiempo transcurrido: " << elapsed << " (mínimo de " << repeats << " ejecuciones)";
+        }
+        if(m == "simd_incremental"){
+          std::cout << "; Bloques omitidos: " << 100.0*skipped << "%; Ahorro de tiempo frente a simd: " << 100.0*(simd_time[omegas[r]] - elapsed)/simd_time[omegas[r]] << "%";
+        }
+        std::cout << std::endl;
+        if(omegas.size() > 1 && r == 0){
+          fixed_iterations = iterations;
+        } else if(omegas.size() > 1){
+          std::cout << "Ahorro de iteraciones con omega automático: " << 100.0*(fixed_iterations - iterations)/fixed_iterations << "%" << std::endl;
+        }
+      } else if(benchmark){
+        std::cout << "Iteraciones: " << iterations << std::endl;
+      }
+      //print_grid(grid, factor);
+      if(!output.empty()){
+        print_grid(grid, factor, precision, output);
+      }
+    }
+  }
 }
@@ -0,0 +1,11 @@
+#!/bin/bash
+
+# Capacitor de placas finitas en 3D con OpenMP. Los argumentos (por ejemplo, '--factor 20') se pasan al ejecutable.
+g++ -O2 -fopenmp -I../../common Capacitor3D.cpp -o capacitor3d
+for i in 1 2 4 8
+do
+  export OMP_NUM_THREADS=$i
+  ./capacitor3d --benchmark "$@"
+done
+#./capacitor3d "$@" | tail -n 100 > capacitor.csv
+#python3 plot.py
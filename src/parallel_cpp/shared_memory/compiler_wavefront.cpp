@@ -1,10 +1,13 @@
 #!/bin/bash
 
-g++ -fopenmp Capacitor_wavefront.cpp
+# Método de iteración: 'wavefront', 'redblack', 'simd', 'tiled', 'multigrid' o 'fmg'. Los argumentos restantes (por ejemplo, '--chequeo 10') se pasan al ejecutable.
+METHOD=${1:-wavefront}
+
+g++ -O2 -fopenmp -I../../common Capacitor_wavefront.cpp
 for i in {1..8}
 do
   export OMP_NUM_THREADS=$i
-  ./a.out | head -n 2
+  ./a.out $METHOD "${@:2}" | head -n 2
 done
-#./a.out | tail -n 100 > capacitor.csv
+#./a.out $METHOD "${@:2}" | tail -n 100 > capacitor.csv
 #python3 plot.py
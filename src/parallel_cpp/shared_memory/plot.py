@@ -1,12 +1,20 @@
 #!/usr/bin/env python3
 
+import sys
 import matplotlib.pyplot as plt
 import pandas as pd
 import numpy as np
 
-file = pd.read_csv('capacitor.csv',delimiter=';', header=None)
+# Uso: 'python3 plot.py [archivo]'; por defecto se lee 'capacitor.csv'.
+name = sys.argv[1] if len(sys.argv) > 1 else 'capacitor.csv'
+
+if name.endswith('.npy'):
+    # Salida binaria ('--salida archivo.npy'): la grilla se mapea directamente desde el archivo, sin copiarla ni interpretar texto.
+    data = np.load(name, mmap_mode='r')
+else:
+    file = pd.read_csv(name, delimiter=';', header=None)
+    data = file.to_numpy(dtype=float)
 
-data = file.to_numpy(dtype=float)
 plt.imshow(data)
 plt.gray()
 plt.show()
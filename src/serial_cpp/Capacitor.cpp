@@ -1,29 +1,23 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <string>
+#include <limits>
+#include <map>
+#include <sys/time.h>
+#include "grid2d.h"
+#include "temporal_blocking.h"
+#include "active_tiles.h"
+#include "symmetry.h"
+#include "grid_output.h"
+#include "omega_tuning.h"
+#include "checkpoint.h"
+#include "telemetry.h"
 
-std::vector<double> grid_generator(int factor, double V1, double V2, double boundary = 0.0){
-
-  // Manejo de excepciones para evitar factores de escala no válidos.
-  if(factor < 1){
-    std::cerr << "El factor de escala debe ser un número entero mayor que cero!" << std::endl;
-    exit(1);
-    }
-
-  // Se define la variable 'column' para facilitar la visualización del código, al ser un valor sumamente utilizado durante el proceso.
-  int column = 10*factor+1;
-  // Se genera una grilla de dimensiones (10*factor)x(10*factor+1), empleando un vector para que sea contiguo en memoria.
-  std::vector<double> phi(10*factor*column);
-  // Generar las condiciones de frotenra, correspondientes a las líneas verticales de potencial. 
-  for(int i=2*factor; i < 8*factor; ++i){
-    phi[i*column+2*factor] = V1;
-    phi[i*column+8*factor] = V2;
-  }
-  // Definimos como valor de retorno la grilla.
-  return phi;
-}
-
-int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tolerance){
+// El argumento 'check_every' permite evaluar la convergencia únicamente cada 'check_every' iteraciones. Con el valor por defecto (1) se evalúa en todas las iteraciones.
+// Con 'checkpoint' se escribe periódicamente la grilla en un punto de control ('checkpoint.h'); al reanudar, el conteo de iteraciones continúa desde 'checkpoint.start'.
+int gauss_seidel(GridVector& phi, double omega, int factor, double tolerance, int check_every = 1, const CheckpointSettings& checkpoint = CheckpointSettings()){
 
   // Manejo de excepciones para asegurar que el factor de escala ingresado a la función sea el mismo valor utilizado en la generación de la grilla.
   if(phi.size() != (10*factor)*(10*factor+1)){
@@ -37,20 +31,32 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
     exit(1);
     }
 
-  // Definimos una copia de la grilla, servirá para establecer la diferencia de la grilla después de cada iteración.
-  std::vector<double> phiCopy = phi;
+  // Manejo de excepciones para asegurar una frecuencia de evaluación de la convergencia válida.
+  if(check_every < 1){
+    std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+    }
+
   // Definimos una variable que irá almacenando la diferencia máxima entre grillas, con un valor inicial de '1.0'.
   double delta = 1.0;
-  // La variable 'diff' se empleará para ir calculando la diferencia entrada por entrada entre las grillas. Si el valor de 'diff' calculado en una iteracion es mayor al almacenado en 'maxDelta', se reestablece el valor de maxDelta.  
-  double diff;
-  double maxDelta;
+  // La variable 'new_value' almacena temporalmente el valor calculado para cada entrada, de forma que la diferencia con el valor anterior se obtiene durante el mismo recorrido de la grilla.
+  // De esta manera no es necesario mantener una copia de la grilla ni recorrerla una segunda vez en cada iteración.
+  double new_value;
+  double maxDelta = 0.0;
+  // La variable 'check' indica si en la iteración actual se evalúa la convergencia.
+  bool check;
   // La variable 'its' hara la funcion de contador del numero de iteraciones.
-  int its = 0;
+  int its = checkpoint.start;
   // Nuevamente, se define la variable 'column' para simplificar la lectura del codigo.
   int column = 10*factor+1;
 
   // Ciclo encargado de iterar hasta haber alcanzado la tolerancia.
   while(delta > tolerance){
+  check = ((its+1) % check_every == 0);
+  // Se establece un valor inicial de 0.0 para la maxima diferencia entre grillas.
+  maxDelta = 0.0;
+  {
+  TELEMETRY_SCOPE(PHASE_SWEEP);
   // Ciclo 'for' que corresponde a las filas de la grilla.
   for(int i=1; i < 10*factor-1; ++i){
     // Ciclo 'for' que corresponde a las columnas de la grilla.
@@ -60,56 +66,838 @@ int gauss_seidel(std::vector<double>& phi, double omega, int factor, double tole
         continue;
 	// En caso de analizar una entrada diferente a las condiciones de frontera, se calcula el promedio de las cuatro entradas subyacentes.
       } else{
-	phi[i*column + j] = ((1.0+omega)*0.25)*(phi[(i+1)*column + j] + phi[(i-1)*column + j] + phi[i*column + (j+1)] + phi[i*column + (j-1)]) - omega*phi[i*column + j];
+	new_value = ((1.0+omega)*0.25)*(phi[(i+1)*column + j] + phi[(i-1)*column + j] + phi[i*column + (j+1)] + phi[i*column + (j-1)]) - omega*phi[i*column + j];
+	// Si se encuentra una diferencia entre el valor nuevo y el anterior mayor a la maxima diferencia, se actualiza 'maxDelta'.
+	if(check){
+	  maxDelta = std::max(maxDelta, std::abs(new_value - phi[i*column + j]));
+	}
+	phi[i*column + j] = new_value;
       }
     }
   }
-
-  // Se establece un valor inicial de 0.0 para la maxima diferencia entre grillas.  
-  maxDelta = 0.0;
-  // Se calcula el valor absoluto (std::abs) de la diferencia entre grillas entrada por entrada, almacenando en 'maxDelta' el mayor valor encontrado.
-  for(int i=1; i < 10*factor-1; ++i){
-    for(int j=1; j < column-1; ++j){
-      diff = std::abs(phi[i*column + j] - phiCopy[i*column + j]);
-      // Si se encuentra una diferencia entre entradas mayor a la maxima diferencia, se actualiza 'maxDelta'.
-      if(diff > maxDelta){
-        maxDelta = diff;
-      }
-    }
   }
 
-  // Se asigna la maxima diferencia encontrada a la variable 'delta'. En caso de ser mayor a la tolerancia, sigue iterando. Caso contrario, se detiene la condicion.
-  delta = maxDelta;
-  // Establecer una copia de la grilla.
-  phiCopy = phi;
   // Sumar una iteracion.
   its += 1;
+  TELEMETRY_ITERATION(its, check ? maxDelta : NAN);
+  // Se asigna la maxima diferencia encontrada a la variable 'delta'. En caso de ser mayor a la tolerancia, sigue iterando. Caso contrario, se detiene la condicion.
+  if(check){
+    delta = maxDelta;
   }
+  save_checkpoint(checkpoint, phi, factor, omega, its);
+  }
+  save_checkpoint(checkpoint, phi, factor, omega, its, true);
   std::cout << "Diferencia máxima: " << maxDelta << std::endl;
   return its;
 }
 
-void print_grid(std::vector<double> &matrix, int factor){
-  std::cout.precision(4);
-  for (int i = 0; i < 10*factor; i++){
-    for (int j = 0; j < 10*factor+1; j++){
-      if (j<10*factor){
-        std::cout<< matrix[i*(10*factor+1)+j] << ";";
+// Función que regresa la medición del tiempo actual.
+double seconds(){
+  struct timeval tmp;
+  double sec;
+  gettimeofday( &tmp, (struct timezone *)0 );
+  sec = tmp.tv_sec + ((double)tmp.tv_usec)/1000000.0;
+
+  return sec;
+}
+
+// Función que realiza las iteraciones de Gauss-Seidel/SOR con ordenamiento rojo-negro, empleando el kernel vectorizado de 'stencil_kernel.h'.
+// La grilla se copia a una grilla rellena con filas alineadas ('Grid2D' de 'grid2d.h') y las entradas fijas se manejan con una máscara precalculada, por lo que el ciclo interno no contiene condiciones.
+// Nótese que el orden de actualización es distinto al de 'gauss_seidel', por lo que el número de iteraciones también lo es.
+// El argumento 'kernel' permite escoger el conjunto de instrucciones: 'auto', 'avx512', 'avx2' o 'scalar'.
+// 'Real' es la precisión de la grilla rellena sobre la que se itera: con 'float' se mueve la mitad de los bytes por barrido, pero la diferencia entre iteraciones no puede bajar del redondeo de simple precisión (alrededor de 1e-7 para potenciales de orden 1).
+// Los puntos de control ('checkpoint') se escriben como en 'gauss_seidel', copiando la grilla rellena a 'phi' únicamente en las iteraciones correspondientes.
+// Con 'depth' mayor que 1 se aplican 'depth' iteraciones por bloque de filas en caché ('temporal_blocking.h'); el resultado de cada iteración es el mismo, pero la convergencia y los puntos de control
+// se evalúan al final de cada bloque temporal, por lo que el número de iteraciones es un múltiplo de 'depth'.
+// Con 'symmetry' se itera únicamente sobre la mitad o el cuarto de la grilla ('symmetry.h'), actualizando las entradas espejo después de cada media iteración, y al final se reconstruye la grilla completa en 'phi'.
+// Con 'active.enabled' se barren únicamente los bloques que aún cambian ('active_tiles.h'); la convergencia se evalúa en los barridos completos de verificación.
+// Si 'skipped' no es nulo, recibe la fracción de bloques omitidos por el modo incremental.
+template<typename Real = double>
+int gauss_seidel_simd(GridVector& phi, double omega, int factor, double tolerance, int check_every = 1, const std::string& kernel = "auto",
+                      const CheckpointSettings& checkpoint = CheckpointSettings(), int depth = 1, const SymmetryDomain& symmetry = SymmetryDomain(),
+                      const ActiveTileSettings& active = ActiveTileSettings(), double* skipped = nullptr){
+
+  if(phi.size() != (10*factor)*(10*factor+1)){
+    std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+    exit(1);
+  }
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+    }
+
+  if(check_every < 1){
+    std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+    }
+
+  // Por debajo de esta tolerancia las diferencias quedan dominadas por el redondeo y la iteración no termina.
+  if(tolerance < 10*std::numeric_limits<Real>::epsilon()){
+    std::cerr << "La tolerancia es menor que la precisión de la grilla; para tolerancias menores a " << 10*std::numeric_limits<Real>::epsilon() << " se debe emplear '--aritmetica mixta' o 'doble'!" << std::endl;
+    exit(1);
+  }
+
+  if(symmetry.mode != SYMMETRY_NONE && (depth > 1 || !checkpoint.path.empty())){
+    std::cerr << "El dominio reducido por simetría no está disponible con el bloque temporal ni con los puntos de control!" << std::endl;
+    exit(1);
+  }
+
+  if(active.enabled && (depth > 1 || symmetry.mode != SYMMETRY_NONE || check_every > 1)){
+    std::cerr << "El modo incremental no está disponible con el bloque temporal, la simetría ni '--chequeo'!" << std::endl;
+    exit(1);
+  }
+
+  BasicStencilKernel<Real> stencil = select_kernel<Real>(kernel);
+  bool reduced = (symmetry.mode != SYMMETRY_NONE);
+  int rows = reduced ? symmetry.rows : 10*factor;
+  int column = reduced ? symmetry.columns : 10*factor+1;
+  Grid2D<Real> padded(rows, column);
+  padded.load(reduced ? reduce_grid(phi, symmetry) : phi);
+  int stride = padded.stride();
+  std::vector<unsigned char> mask = reduced ? symmetry_mask(symmetry, rows, stride) : capacitor_mask(rows, column, stride, factor);
+  int blockRows = temporal_block_rows<Real>(stride, depth);
+  check_temporal_depth(depth, blockRows);
+  ActiveTiles tiles;
+  if(active.enabled){
+    tiles = active_tiles(rows, stride, active);
+  }
+
+  double delta = 1.0;
+  double maxDelta = 0.0;
+  int its = checkpoint.start;
+  while(delta > tolerance){
+    // Media iteración de las entradas rojas seguida de la media iteración de las entradas negras, o 'depth' iteraciones por bloques de filas.
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    if(active.enabled){
+      schedule_tiles(tiles, its, tolerance);
+      maxDelta = active_sweeps(stencil, padded.data(), mask.data(), stride, tiles, (Real)omega);
+    } else if(depth > 1){
+      maxDelta = temporal_sweeps(stencil, padded.data(), mask.data(), stride, rows, depth, blockRows, (Real)omega);
+    } else{
+      maxDelta = stencil.sweep(padded.data(), mask.data(), stride, 1, rows-1, 0, 0, omega);
+      refresh_mirror(padded.data(), stride, symmetry);
+      maxDelta = std::max(maxDelta, (double)stencil.sweep(padded.data(), mask.data(), stride, 1, rows-1, 0, 1, omega));
+      refresh_mirror(padded.data(), stride, symmetry);
+    }
+    }
+    // Se evalúa la convergencia (o se escribe el punto de control) si el bloque de iteraciones alcanzó un múltiplo de 'check_every' (o de 'checkpoint.every').
+    int previous = its;
+    its += depth;
+    bool check = active.enabled ? tiles.full : (its/check_every != previous/check_every);
+    TELEMETRY_ITERATION(its, check ? maxDelta : NAN);
+    if(check){
+      delta = maxDelta;
+    }
+    if(!checkpoint.path.empty() && its/checkpoint.every != previous/checkpoint.every){
+      padded.store(phi);
+      save_checkpoint(checkpoint, phi, factor, omega, its);
+    }
+  }
+
+  if(reduced){
+    GridVector section((size_t)rows*column);
+    padded.store(section);
+    phi = expand_grid(section, symmetry);
+  } else{
+    padded.store(phi);
+  }
+  save_checkpoint(checkpoint, phi, factor, omega, its, true);
+  std::cout << "Kernel: " << stencil.name << std::endl;
+  if(reduced){
+    std::cout << "Simetría: " << symmetry_name(symmetry) << " (" << rows << "x" << column << " entradas, " << 100.0*rows*column/((10.0*factor)*(10*factor+1)) << "% de la grilla)" << std::endl;
+  }
+  if(depth > 1){
+    std::cout << "Bloque temporal: " << depth << " iteraciones en bloques de " << blockRows << " filas" << std::endl;
+  }
+  if(active.enabled){
+    report_active_tiles(tiles);
+  }
+  if(skipped != nullptr){
+    *skipped = active.enabled ? skipped_fraction(tiles) : 0.0;
+  }
+  std::cout << "Diferencia máxima: " << maxDelta << std::endl;
+  return its;
+}
+
+// Refinamiento iterativo en precisión mixta con los kernels de 'stencil_kernel.h'.
+// La solución y su residuo r = vecinos - 4*phi se mantienen en doble precisión. En cada corrección se resuelve 4*e - vecinos(e) = r en simple precisión con barridos rojo-negro (con término fuente) a partir de e = 0, y se suma e a la solución en doble precisión.
+// Cada corrección reduce la diferencia de sus barridos hasta 'inner_reduction' veces la escala del residuo, de forma que la mayoría de los barridos se realiza en simple precisión sin limitar la exactitud final.
+// La convergencia se evalúa con la mayor actualización de Jacobi, max|r|/4, que es comparable con la diferencia máxima de 'gauss_seidel_simd'. Regresa el total de barridos en simple precisión; las correcciones se reportan aparte.
+int gauss_seidel_mixed(GridVector& phi, double omega, int factor, double tolerance, int check_every = 1, const std::string& kernel = "auto"){
+
+  if(phi.size() != (10*factor)*(10*factor+1)){
+    std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+    exit(1);
+  }
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+    }
+
+  if(check_every < 1){
+    std::cerr << "La frecuencia de evaluación de la convergencia debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+    }
+
+  BasicStencilKernel<float> stencil = select_kernel<float>(kernel);
+  int rows = 10*factor;
+  int column = 10*factor+1;
+  Grid2D<float> correction(rows, column);
+  Grid2D<float> source(rows, column);
+  int stride = correction.stride();
+  std::vector<unsigned char> mask = capacitor_mask(rows, column, stride, factor);
+  const double inner_reduction = 1e-3;
+
+  int sweeps = 0;
+  int corrections = 0;
+  double residual = 0.0;
+  while(true){
+    // Residuo en doble precisión, escrito en simple precisión como término fuente de la corrección.
+    // En la telemetría la línea 'k' reporta el residuo después de 'k' correcciones: el cálculo del residuo es la fase de convergencia y los barridos en simple precisión de la corrección anterior la fase de barrido.
+    residual = 0.0;
+    {
+    TELEMETRY_SCOPE(PHASE_CHECK);
+    for(int i=1; i < rows-1; ++i){
+      for(int j=1; j < column-1; ++j){
+        if((2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor)){
+          continue;
+        }
+        double r = phi[(i+1)*column + j] + phi[(i-1)*column + j] + phi[i*column + (j+1)] + phi[i*column + (j-1)] - 4.0*phi[i*column + j];
+        residual = std::max(residual, std::abs(r));
+        source(i, j) = (float)r;
+      }
+    }
+    }
+    residual *= 0.25;
+    TELEMETRY_ITERATION(corrections, residual);
+    if(residual <= tolerance){
+      break;
+    }
+
+    correction.fill(0.0f);
+    double inner_tolerance = std::max(inner_reduction*residual, 0.5*tolerance);
+    double delta = 1.0;
+    int its = 0;
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    while(delta > inner_tolerance){
+      double maxDelta = stencil.sweep_source(correction.data(), source.data(), mask.data(), stride, 1, rows-1, 0, 0, omega);
+      maxDelta = std::max(maxDelta, (double)stencil.sweep_source(correction.data(), source.data(), mask.data(), stride, 1, rows-1, 0, 1, omega));
+      its += 1;
+      if(its % check_every == 0){
+        delta = maxDelta;
+      }
+    }
+    sweeps += its;
+    corrections += 1;
+
+    for(int i=1; i < rows-1; ++i){
+      for(int j=1; j < column-1; ++j){
+        phi[i*column + j] += correction(i, j);
+      }
+    }
+  }
+
+  std::cout << "Kernel: " << stencil.name << " (simple precisión)" << std::endl;
+  std::cout << "Correcciones en doble precisión: " << corrections << std::endl;
+  std::cout << "Residuo máximo / 4: " << residual << std::endl;
+  return sweeps;
+}
+
+// Estructura que representa un nivel de la jerarquía de multigrid.
+// El nivel 0 corresponde a la grilla original y cada nivel siguiente posee aproximadamente la mitad de filas y columnas, de forma que la entrada (I,J) de un nivel grueso coincide con la entrada (2I,2J) del nivel fino.
+struct Level{
+  int rows;
+  int columns;
+  // Solución (en el nivel 0) o corrección (en los niveles gruesos).
+  std::vector<double> u;
+  // Término fuente de la ecuación discreta A*u = f.
+  std::vector<double> f;
+  // Residuo r = f - A*u.
+  std::vector<double> r;
+  // Indica las entradas con condiciones de Dirichlet: los bordes de la grilla y las líneas de potencial.
+  std::vector<char> fixed;
+  // Coeficientes de la matriz A de los niveles gruesos: 9 coeficientes por entrada, con índice k = (di+1)*3 + (dj+1) para el vecino (i+di, j+dj).
+  // En el nivel 0 se encuentra vacío, ya que se emplea directamente la diferencia central de cinco puntos.
+  std::vector<double> stencil;
+};
+
+// Coeficiente de la matriz A del nivel 'level' que acopla la entrada libre (i,j) con su vecina libre (i+di,j+dj).
+// Las entradas fijas no forman parte de las incógnitas, por lo que sus coeficientes son nulos.
+double coefficient(const Level& level, int i, int j, int di, int dj){
+  if(!level.stencil.empty()){
+    return level.stencil[(i*level.columns + j)*9 + (di+1)*3 + (dj+1)];
+  }
+  if(level.fixed[(i+di)*level.columns + (j+dj)]){
+    return 0.0;
+  }
+  if(di == 0 && dj == 0){
+    return 4.0;
+  }
+  return (std::abs(di) + std::abs(dj) == 1) ? -1.0 : 0.0;
+}
+
+// Peso de la interpolación bilineal de la entrada gruesa I sobre la entrada fina i, en una dirección.
+double interpolation_weight(int i, int I){
+  int distance = std::abs(i - 2*I);
+  if(distance == 0){
+    return 1.0;
+  }
+  return (distance == 1) ? 0.5 : 0.0;
+}
+
+// Construcción de la matriz del nivel grueso mediante el producto de Galerkin A_c = R*A*P, donde P es la interpolación bilineal hacia las entradas finas libres y R = P^T/4 la ponderación completa.
+// A diferencia de discretizar nuevamente la ecuación de Laplace, este producto respeta la posición de las líneas de potencial y de los bordes aunque no coincidan con entradas del nivel grueso.
+void galerkin(const Level& fine, Level& coarse){
+  coarse.stencil.assign(coarse.rows*coarse.columns*9, 0.0);
+  // Para cada entrada gruesa N se aplica A a la columna N de P, la cual es no nula en un bloque 3x3 alrededor de la entrada fina (2N_i, 2N_j). El resultado 'v' es no nulo en un bloque 5x5.
+  for(int NI=1; NI < coarse.rows-1; ++NI){
+    for(int NJ=1; NJ < coarse.columns-1; ++NJ){
+      if(coarse.fixed[NI*coarse.columns + NJ]){
+        continue;
+      }
+      double v[5][5] = {};
+      for(int pi=-1; pi <= 1; ++pi){
+        for(int pj=-1; pj <= 1; ++pj){
+          int i = 2*NI+pi;
+          int j = 2*NJ+pj;
+          if(i >= fine.rows-1 || j >= fine.columns-1 || fine.fixed[i*fine.columns + j]){
+            continue;
+          }
+          double p = interpolation_weight(i, NI)*interpolation_weight(j, NJ);
+          for(int di=-1; di <= 1; ++di){
+            for(int dj=-1; dj <= 1; ++dj){
+              if(fine.fixed[(i+di)*fine.columns + (j+dj)]){
+                continue;
+              }
+              // La matriz es simétrica, por lo que A[(i+di,j+dj),(i,j)] = A[(i,j),(i+di,j+dj)].
+              v[pi+di+2][pj+dj+2] += coefficient(fine, i, j, di, dj)*p;
+            }
+          }
+        }
+      }
+      // Se aplica R = P^T/4 al vector 'v' para obtener la columna N de la matriz gruesa.
+      for(int vi=0; vi < 5; ++vi){
+        for(int vj=0; vj < 5; ++vj){
+          if(v[vi][vj] == 0.0){
+            continue;
+          }
+          int i = 2*NI+vi-2;
+          int j = 2*NJ+vj-2;
+          for(int CI=(i-1)/2; CI <= (i+1)/2; ++CI){
+            for(int CJ=(j-1)/2; CJ <= (j+1)/2; ++CJ){
+              double w = interpolation_weight(i, CI)*interpolation_weight(j, CJ);
+              if(w == 0.0 || coarse.fixed[CI*coarse.columns + CJ]){
+                continue;
+              }
+              coarse.stencil[(CI*coarse.columns + CJ)*9 + (NI-CI+1)*3 + (NJ-CJ+1)] += 0.25*w*v[vi][vj];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Función que construye la jerarquía de niveles a partir de la grilla generada por 'grid_generator'.
+// Se reducen las dimensiones mientras el nivel grueso tenga al menos 5 filas y 5 columnas.
+std::vector<Level> build_levels(const GridVector& phi, int factor){
+  std::vector<Level> levels(1);
+  Level& fine = levels[0];
+  fine.rows = 10*factor;
+  fine.columns = 10*factor+1;
+  fine.u.assign(phi.begin(), phi.end());
+  fine.f.assign(fine.rows*fine.columns, 0.0);
+  fine.r.assign(fine.rows*fine.columns, 0.0);
+  fine.fixed.assign(fine.rows*fine.columns, 0);
+  for(int i=0; i < fine.rows; ++i){
+    for(int j=0; j < fine.columns; ++j){
+      bool border = (i == 0 || j == 0 || i == fine.rows-1 || j == fine.columns-1);
+      bool plate = (2*factor <= i && i < 8*factor) && (j == 2*factor || j == 8*factor);
+      fine.fixed[i*fine.columns + j] = (border || plate);
+    }
+  }
+
+  while(levels.back().rows/2+1 >= 5 && levels.back().columns/2+1 >= 5){
+    const Level& prev = levels.back();
+    Level coarse;
+    coarse.rows = prev.rows/2+1;
+    coarse.columns = prev.columns/2+1;
+    coarse.u.assign(coarse.rows*coarse.columns, 0.0);
+    coarse.f.assign(coarse.rows*coarse.columns, 0.0);
+    coarse.r.assign(coarse.rows*coarse.columns, 0.0);
+    coarse.fixed.assign(coarse.rows*coarse.columns, 0);
+    // Una entrada gruesa es fija si está en el borde, si su entrada fina correspondiente queda fuera de la grilla fina o si dicha entrada es fija.
+    for(int I=0; I < coarse.rows; ++I){
+      for(int J=0; J < coarse.columns; ++J){
+        bool border = (I == 0 || J == 0 || I == coarse.rows-1 || J == coarse.columns-1);
+        bool outside = (2*I >= prev.rows || 2*J >= prev.columns);
+        coarse.fixed[I*coarse.columns + J] = (border || outside || prev.fixed[(2*I)*prev.columns + 2*J]);
+      }
+    }
+    galerkin(prev, coarse);
+    levels.push_back(coarse);
+  }
+  return levels;
+}
+
+// Barrido de Gauss-Seidel/SOR sobre un nivel, empleado como suavizador.
+// En el nivel 0 es la misma actualización de 'gauss_seidel', incorporando el término fuente: u = (1+omega)/4*(vecinos + f) - omega*u.
+// En los niveles gruesos se emplean los 9 coeficientes de la matriz de Galerkin.
+// Regresa la mayor diferencia entre el valor nuevo y el anterior.
+double smooth(Level& level, double omega){
+  int column = level.columns;
+  double maxDelta = 0.0;
+  for(int i=1; i < level.rows-1; ++i){
+    for(int j=1; j < column-1; ++j){
+      if(level.fixed[i*column + j]){
+        continue;
       }
-      else{
-        std::cout<<matrix[i*(10*factor+1)+j]<< std::endl;
+      double new_value;
+      if(level.stencil.empty()){
+        new_value = ((1.0+omega)*0.25)*(level.u[(i+1)*column + j] + level.u[(i-1)*column + j] + level.u[i*column + (j+1)] + level.u[i*column + (j-1)] + level.f[i*column + j]) - omega*level.u[i*column + j];
+      } else{
+        const double* a = &level.stencil[(i*column + j)*9];
+        double sum = level.f[i*column + j];
+        for(int k=0; k < 9; ++k){
+          if(k != 4){
+            sum -= a[k]*level.u[(i+k/3-1)*column + (j+k%3-1)];
+          }
+        }
+        new_value = (1.0+omega)*sum/a[4] - omega*level.u[i*column + j];
       }
+      maxDelta = std::max(maxDelta, std::abs(new_value - level.u[i*column + j]));
+      level.u[i*column + j] = new_value;
+    }
+  }
+  return maxDelta;
+}
+
+// Cálculo del residuo r = f - A*u. El residuo es nulo en las entradas fijas.
+void residual(Level& level){
+  int column = level.columns;
+  for(int i=1; i < level.rows-1; ++i){
+    for(int j=1; j < column-1; ++j){
+      if(level.fixed[i*column + j]){
+        level.r[i*column + j] = 0.0;
+      } else if(level.stencil.empty()){
+        level.r[i*column + j] = level.f[i*column + j] - (4.0*level.u[i*column + j] - level.u[(i+1)*column + j] - level.u[(i-1)*column + j] - level.u[i*column + (j+1)] - level.u[i*column + (j-1)]);
+      } else{
+        const double* a = &level.stencil[(i*column + j)*9];
+        double sum = level.f[i*column + j];
+        for(int k=0; k < 9; ++k){
+          sum -= a[k]*level.u[(i+k/3-1)*column + (j+k%3-1)];
+        }
+        level.r[i*column + j] = sum;
       }
+    }
+  }
+}
+
+// Restricción del residuo del nivel fino al término fuente del nivel grueso mediante ponderación completa (full weighting), R = P^T/4.
+// Las entradas finas fuera de la grilla se consideran nulas.
+void restrict_residual(const Level& fine, Level& coarse){
+  for(int I=1; I < coarse.rows-1; ++I){
+    for(int J=1; J < coarse.columns-1; ++J){
+      double sum = 0.0;
+      if(!coarse.fixed[I*coarse.columns + J]){
+        for(int di=-1; di <= 1; ++di){
+          for(int dj=-1; dj <= 1; ++dj){
+            int i = 2*I+di;
+            int j = 2*J+dj;
+            if(i < fine.rows && j < fine.columns){
+              // Pesos 4, 2 y 1 para la entrada central, las vecinas directas y las diagonales, respectivamente.
+              sum += (2-std::abs(di))*(2-std::abs(dj))*fine.r[i*fine.columns + j];
+            }
+          }
+        }
       }
- }
+      coarse.f[I*coarse.columns + J] = sum/16.0;
+    }
+  }
+}
+
+// Interpolación bilineal de la corrección del nivel grueso, sumándola a las entradas libres del nivel fino.
+void prolong_correction(const Level& coarse, Level& fine){
+  for(int i=1; i < fine.rows-1; ++i){
+    for(int j=1; j < fine.columns-1; ++j){
+      if(fine.fixed[i*fine.columns + j]){
+        continue;
+      }
+      int I = i/2;
+      int J = j/2;
+      // Para índices impares se promedian las dos entradas gruesas vecinas en esa dirección.
+      int I2 = I + i%2;
+      int J2 = J + j%2;
+      fine.u[i*fine.columns + j] += 0.25*(coarse.u[I*coarse.columns + J] + coarse.u[I*coarse.columns + J2] + coarse.u[I2*coarse.columns + J] + coarse.u[I2*coarse.columns + J2]);
+    }
+  }
+}
+
+// Ciclo V recursivo a partir del nivel 'l'. Se realizan 'nu' barridos de suavizado antes y después de la corrección del nivel grueso.
+// En el nivel más grueso se realizan barridos hasta que la diferencia sea despreciable.
+void v_cycle(std::vector<Level>& levels, int l, double omega, int nu){
+  Level& level = levels[l];
+  if(l == (int)levels.size()-1){
+    for(int k=0; k < 1000; ++k){
+      if(smooth(level, omega) < 1e-14){
+        break;
+      }
+    }
+    return;
+  }
+  for(int k=0; k < nu; ++k){
+    smooth(level, omega);
+  }
+  residual(level);
+  Level& coarse = levels[l+1];
+  restrict_residual(level, coarse);
+  // La corrección inicial es nula, incluyendo las entradas fijas (condiciones de Dirichlet homogéneas).
+  std::fill(coarse.u.begin(), coarse.u.end(), 0.0);
+  v_cycle(levels, l+1, omega, nu);
+  prolong_correction(coarse, level);
+  for(int k=0; k < nu; ++k){
+    smooth(level, omega);
+  }
+}
+
+// Función que resuelve el problema del capacitor mediante multigrid geométrico.
+// Los argumentos son los mismos que en 'gauss_seidel'; en este caso 'omega' corresponde al parámetro del suavizador (omega = 0 equivale a Gauss-Seidel).
+// Si 'fmg' es verdadero, se emplea multigrid completo (Full Multigrid): se resuelve primero en el nivel más grueso y se interpola la solución como valor inicial de cada nivel más fino, seguido de un ciclo V por nivel.
+// La convergencia se evalúa con la mayor diferencia de la grilla entre dos ciclos V consecutivos. Regresa el número de ciclos V realizados en el nivel 0.
+int multigrid(GridVector& phi, double omega, int factor, double tolerance, bool fmg = false){
+
+  if(phi.size() != (10*factor)*(10*factor+1)){
+    std::cerr << "El factor de escala ingresado es diferente al utilizado para generar la grilla!" << std::endl;
+    exit(1);
+  }
+
+  if(tolerance <= 0){
+    std::cerr << "El valor de tolerancia no puede ser nulo ni negativo!" << std::endl;
+    exit(1);
+    }
+
+  std::vector<Level> levels = build_levels(phi, factor);
+  int L = levels.size();
+  // Número de barridos de suavizado antes y después de cada corrección.
+  int nu = 2;
+  int its = 0;
 
-int main(){
+  if(fmg){
+    // El término fuente de cada nivel grueso es la restricción del residuo de la grilla inicial, el cual contiene la contribución de las líneas de potencial.
+    residual(levels[0]);
+    for(int l=1; l < L; ++l){
+      restrict_residual(levels[l-1], levels[l]);
+      levels[l].r = levels[l].f;
+    }
+    v_cycle(levels, L-1, omega, nu);
+    // Se interpola la solución de cada nivel como valor inicial del siguiente nivel fino, seguido de un ciclo V.
+    for(int l=L-2; l >= 0; --l){
+      prolong_correction(levels[l+1], levels[l]);
+      v_cycle(levels, l, omega, nu);
+    }
+    its += 1;
+  }
+
+  // Copia de la solución al inicio de cada ciclo, para evaluar la diferencia entre ciclos. Su costo es pequeño frente al de un ciclo V completo.
+  std::vector<double> previous;
+  double delta = 1.0;
+  while(delta > tolerance){
+    {
+    TELEMETRY_SCOPE(PHASE_SWEEP);
+    previous = levels[0].u;
+    v_cycle(levels, 0, omega, nu);
+    }
+    {
+    TELEMETRY_SCOPE(PHASE_CHECK);
+    delta = 0.0;
+    for(size_t k=0; k < previous.size(); ++k){
+      delta = std::max(delta, std::abs(levels[0].u[k] - previous[k]));
+    }
+    }
+    its += 1;
+    TELEMETRY_ITERATION(its, delta);
+  }
+
+  phi.assign(levels[0].u.begin(), levels[0].u.end());
+  std::cout << "Niveles de multigrid: " << L << std::endl;
+  std::cout << "Diferencia máxima: " << delta << std::endl;
+  return its;
+}
+
+// Impresión de la grilla con 'grid_output.h': CSV en la salida estándar por defecto, o en el archivo 'path' ('.npy' para el formato binario de numpy).
+void print_grid(GridVector &matrix, int factor, int precision = 4, const std::string& path = ""){
+  write_grid(path, matrix, 10*factor, 10*factor+1, precision);
+}
+
+// El método se escoge desde la terminal: './a.out' o './a.out gauss_seidel' para Gauss-Seidel/SOR, './a.out simd' para el kernel vectorizado rojo-negro, './a.out multigrid' para ciclos V y './a.out fmg' para multigrid completo.
+// Opciones adicionales:
+//   '--chequeo N' evalúa la convergencia de Gauss-Seidel únicamente cada N iteraciones.
+//   '--kernel K' escoge el conjunto de instrucciones del método 'simd': 'auto', 'avx512', 'avx2' o 'scalar'.
+//   '--simetria S' resuelve el método 'simd' sobre un dominio reducido por simetría y reconstruye la grilla completa ('symmetry.h'): 'mitad', 'cuarto' (requiere V1 = -V2 o V1 = V2), 'auto' o 'ninguna' (por defecto).
+//   '--bloque-temporal T' aplica en el método 'simd' T iteraciones consecutivas a cada bloque de filas en caché ('temporal_blocking.h'); con T = 1 (por defecto) se recorre la grilla completa en cada iteración.
+//   '--incremental' barre en el método 'simd' únicamente los bloques que aún cambian y sus vecinos, con barridos completos de verificación ('active_tiles.h').
+//     '--incremental-filas N' y '--incremental-columnas N' cambian el tamaño de los bloques (32x128 por defecto; las columnas, múltiplo de 16), '--verificacion N' las iteraciones entre verificaciones (10)
+//     y '--umbral U' la fracción de la tolerancia bajo la cual un bloque se considera convergido (0.1). Con '--comparar' se ejecuta además 'simd_incremental' y se reporta la fracción de bloques omitidos y el ahorro de tiempo frente a 'simd' con el mismo omega (menor tiempo de ACTIVE_COMPARE_REPEATS ejecuciones de cada modo).
+//   '--factor N' cambia el factor de escala de la grilla.
+//   '--tolerancia T' cambia la tolerancia de convergencia.
+//   '--comparar' ejecuta los tres métodos y reporta iteraciones y tiempo de cada uno, sin imprimir la grilla.
+//   '--salida ARCHIVO' escribe la grilla en un archivo en lugar de la salida estándar: '.npy' para el formato binario de numpy o CSV con cualquier otra extensión.
+//   '--precision P' cambia las cifras significativas del CSV (4 por defecto).
+//   '--omega W' cambia el parámetro de sobre-relajación de Gauss-Seidel; con '--omega auto' se escoge el óptimo estimado en 'omega_tuning.h' (guardado en 'omega_cache.dat').
+//     Junto con '--comparar', los métodos de sobre-relajación se ejecutan también con el omega fijo por defecto para reportar el ahorro de iteraciones.
+//   '--aritmetica A' escoge la precisión del método 'simd': 'doble' (por defecto), 'simple' (grilla en 'float') o 'mixta' (refinamiento iterativo, ver 'gauss_seidel_mixed').
+//     Con '--comparar' se ejecutan las tres y se reporta también la diferencia con el resultado en doble precisión.
+//   '--respaldo ARCHIVO' escribe un punto de control de la grilla cada 100 iteraciones (o cada N con '--respaldo-cada N') y al finalizar, en el formato binario de 'checkpoint.h'.
+//   '--reanudar' continúa desde el punto de control de '--respaldo' si existe; de lo contrario inicia desde cero.
+//   '--inicial ARCHIVO' interpola como valor inicial una solución de otro factor de escala (un punto de control o la salida '.bin' de la versión distribuida).
+//     Los puntos de control y el valor inicial están disponibles en los métodos 'gauss_seidel' y 'simd' (aritmética doble o simple).
+//   '--telemetria ARCHIVO' escribe una línea JSON por iteración con el residuo y el tiempo de cada fase ('-' para la salida de error); '--contadores' agrega los contadores de hardware.
+//     Requiere compilar con '-DCAPACITOR_TELEMETRY' (ver 'telemetry.h'); en las correcciones de '--aritmetica mixta' cada línea corresponde a una corrección y en multigrid a un ciclo.
+//   '--benchmark' reporta iteraciones y tiempo del método sin imprimir la grilla (ver 'src/benchmark').
+int main(int argc, char* argv[]){
   int factor = 10;
   double volt1 = 1.0;
   double volt2 = -1.0;
-  std::vector<double> grid = grid_generator(factor, volt1, volt2);
-  double omega = 0.9;
+  const double fixed_omega = 0.9;
+  double omega = fixed_omega;
+  // Parámetro del suavizador de multigrid. Gauss-Seidel (omega = 0) es un mejor suavizador que la sobre-relajación.
+  double mg_omega = 0.0;
   double tolerance = 1e-4;
-  int iterations = gauss_seidel(grid,omega, factor, tolerance);
-  print_grid(grid,factor);
+  int check_every = 1;
+  int depth = 1;
+  std::string symmetry_option = "ninguna";
+  ActiveTileSettings active;
+  std::string method = "gauss_seidel";
+  std::string kernel = "auto";
+  bool compare = false;
+  std::string output = "";
+  int precision = 4;
+  bool benchmark = false;
+  std::string arithmetic = "doble";
+  CheckpointSettings checkpoint;
+  std::string telemetry_path = "";
+  bool counters = false;
+  for(int a = 1; a < argc; ++a){
+    std::string arg = argv[a];
+    if(arg == "--chequeo" && a+1 < argc){
+      check_every = std::stoi(argv[++a]);
+    } else if(arg == "--kernel" && a+1 < argc){
+      kernel = argv[++a];
+    } else if(arg == "--bloque-temporal" && a+1 < argc){
+      depth = std::stoi(argv[++a]);
+    } else if(arg == "--simetria" && a+1 < argc){
+      symmetry_option = argv[++a];
+    } else if(arg == "--incremental"){
+      active.enabled = true;
+    } else if(arg == "--incremental-filas" && a+1 < argc){
+      active.tileRows = std::stoi(argv[++a]);
+    } else if(arg == "--incremental-columnas" && a+1 < argc){
+      active.tileColumns = std::stoi(argv[++a]);
+    } else if(arg == "--verificacion" && a+1 < argc){
+      active.verify_every = std::stoi(argv[++a]);
+    } else if(arg == "--umbral" && a+1 < argc){
+      active.threshold = std::stod(argv[++a]);
+    } else if(arg == "--factor" && a+1 < argc){
+      factor = std::stoi(argv[++a]);
+    } else if(arg == "--tolerancia" && a+1 < argc){
+      tolerance = std::stod(argv[++a]);
+    } else if(arg == "--comparar"){
+      compare = true;
+    } else if(arg == "--salida" && a+1 < argc){
+      output = argv[++a];
+    } else if(arg == "--precision" && a+1 < argc){
+      precision = std::stoi(argv[++a]);
+    } else if(arg == "--omega" && a+1 < argc){
+      omega = parse_omega(argv[++a]);
+    } else if(arg == "--aritmetica" && a+1 < argc){
+      arithmetic = argv[++a];
+    } else if(arg == "--respaldo" && a+1 < argc){
+      checkpoint.path = argv[++a];
+    } else if(arg == "--respaldo-cada" && a+1 < argc){
+      checkpoint.every = std::stoi(argv[++a]);
+    } else if(arg == "--reanudar"){
+      checkpoint.resume = true;
+    } else if(arg == "--inicial" && a+1 < argc){
+      checkpoint.initial = argv[++a];
+    } else if(arg == "--telemetria" && a+1 < argc){
+      telemetry_path = argv[++a];
+    } else if(arg == "--contadores"){
+      counters = true;
+    } else if(arg == "--benchmark"){
+      benchmark = true;
+    } else if(arg == "gauss_seidel" || arg == "simd" || arg == "multigrid" || arg == "fmg"){
+      method = arg;
+    } else{
+      std::cerr << "Argumento no reconocido: " << arg << std::endl;
+      exit(1);
+    }
+  }
+
+  if(arithmetic != "doble" && arithmetic != "simple" && arithmetic != "mixta"){
+    std::cerr << "Aritmética no reconocida: " << arithmetic << ". Las opciones son 'doble', 'simple' y 'mixta'." << std::endl;
+    exit(1);
+  }
+
+  if(depth != 1 && method == "simd" && arithmetic == "mixta"){
+    std::cerr << "El bloque temporal no está disponible con '--aritmetica mixta'!" << std::endl;
+    exit(1);
+  }
+
+  check_active_settings(active);
+  if(active.enabled && !compare && (method != "simd" || arithmetic == "mixta")){
+    std::cerr << "El modo incremental sólo está disponible en el método 'simd' con aritmética doble o simple!" << std::endl;
+    exit(1);
+  }
+
+  SymmetryDomain symmetry = symmetry_domain(symmetry_option, factor, volt1, volt2);
+  if(symmetry.mode != SYMMETRY_NONE && (compare || method != "simd" || arithmetic == "mixta")){
+    std::cerr << "El dominio reducido por simetría sólo está disponible en el método 'simd' con aritmética doble o simple, sin '--comparar'!" << std::endl;
+    exit(1);
+  }
+
+  bool restart = !checkpoint.path.empty() || checkpoint.resume || !checkpoint.initial.empty();
+  if(restart && (compare || method == "multigrid" || method == "fmg" || (method == "simd" && arithmetic == "mixta"))){
+    std::cerr << "Los puntos de control y el valor inicial sólo están disponibles en los métodos 'gauss_seidel' y 'simd' con aritmética doble o simple!" << std::endl;
+    exit(1);
+  }
+  if(checkpoint.every < 1){
+    std::cerr << "La frecuencia de los puntos de control debe ser un número entero mayor que cero!" << std::endl;
+    exit(1);
+  }
+  if(checkpoint.resume && checkpoint.path.empty()){
+    std::cerr << "La opción '--reanudar' requiere el archivo del punto de control ('--respaldo')!" << std::endl;
+    exit(1);
+  }
+
+  bool automatic = (omega == AUTO_OMEGA);
+  if(automatic){
+    omega = auto_omega(factor);
+  }
+
+  if(!telemetry_path.empty()){
+    if(compare){
+      std::cerr << "La telemetría registra una única ejecución, por lo que no está disponible con '--comparar'!" << std::endl;
+      exit(1);
+    }
+    telemetry_open(telemetry_path, counters);
+  }
+
+  // Método 'simd' con la aritmética escogida y, opcionalmente, el modo incremental.
+  auto simd = [&](GridVector& grid, double w, const std::string& mode, const ActiveTileSettings& tiles){
+    if(mode == "simple"){
+      return gauss_seidel_simd<float>(grid, w, factor, tolerance, check_every, kernel, checkpoint, depth, symmetry, tiles);
+    } else if(mode == "mixta"){
+      return gauss_seidel_mixed(grid, w, factor, tolerance, check_every, kernel);
+    }
+    return gauss_seidel_simd<double>(grid, w, factor, tolerance, check_every, kernel, checkpoint, depth, symmetry, tiles);
+  };
+
+  if(compare){
+    std::vector<std::string> methods = {"gauss_seidel", "simd", "simd_simple", "simd_mixta", "simd_incremental", "multigrid", "fmg"};
+    GridVector reference;
+    // Resultado y tiempo de 'simd' en doble precisión para cada omega, con los que se comparan las demás aritméticas y el modo incremental.
+    std::map<double, GridVector> simd_reference;
+    std::map<double, double> simd_time;
+    ActiveTileSettings incremental = active;
+    incremental.enabled = true;
+    for(const std::string& m : methods){
+      if(m == "simd_simple" && tolerance < 10*std::numeric_limits<float>::epsilon()){
+        std::cout << "Método: " << m << "; omitido, la tolerancia es menor que la precisión de 'float'" << std::endl;
+        continue;
+      }
+      bool sor = (m == "gauss_seidel" || m == "simd" || m == "simd_incremental");
+      // Con omega automático, cada método de sobre-relajación se ejecuta primero con el omega fijo como referencia.
+      std::vector<double> omegas = {omega};
+      if(sor && automatic){
+        omegas = {fixed_omega, omega};
+      }
+      // 'simd' y 'simd_incremental' se repiten y se toma el menor tiempo de cada uno, de modo que ambos se comparan con la caché y la memoria en el mismo estado.
+      int repeats = (m == "simd" || m == "simd_incremental") ? ACTIVE_COMPARE_REPEATS : 1;
+      int fixed_iterations = 0;
+      for(size_t r=0; r < omegas.size(); ++r){
+        GridVector grid;
+        int iterations = 0;
+        double elapsed = 0.0;
+        double skipped = 0.0;
+        for(int repeat=0; repeat < repeats; ++repeat){
+          grid = grid_generator(factor, volt1, volt2);
+          double time_1 = seconds();
+          if(m == "gauss_seidel"){
+            iterations = gauss_seidel(grid, omegas[r], factor, tolerance, check_every);
+          } else if(m == "simd"){
+            iterations = simd(grid, omegas[r], "doble", ActiveTileSettings());
+          } else if(m == "simd_simple" || m == "simd_mixta"){
+            iterations = simd(grid, omegas[r], m.substr(5), ActiveTileSettings());
+          } else if(m == "simd_incremental"){
+            // El modo incremental escoge los bloques en cada iteración, por lo que no emplea el bloque temporal ni '--chequeo'.
+            iterations = gauss_seidel_simd<double>(grid, omegas[r], factor, tolerance, 1, kernel, checkpoint, 1, symmetry, incremental, &skipped);
+          } else{
+            iterations = multigrid(grid, mg_omega, factor, tolerance, m == "fmg");
+          }
+          double time_2 = seconds();
+          elapsed = (repeat == 0) ? time_2 - time_1 : std::min(elapsed, time_2 - time_1);
+        }
+        if(m == "gauss_seidel" && reference.empty()){
+          reference = grid;
+        } else if(m == "simd"){
+          simd_reference[omegas[r]] = grid;
+          simd_time[omegas[r]] = elapsed;
+        }
+        double difference = 0.0;
+        for(size_t k=0; k < grid.size(); ++k){
+          difference = std::max(difference, std::abs(grid[k] - reference[k]));
+        }
+        std::cout << "Método: " << m;
+        if(sor){
+          std::cout << "; Omega: " << omegas[r];
+        }
+        std::cout << "; Iteraciones: " << iterations << "; Tiempo transcurrido: " << elapsed;
+        if(repeats > 1){
+          std::cout << " (mínimo de " << repeats << " ejecuciones)";
+        }
+        std::cout << "; Diferencia con gauss_seidel: " << difference;
+        if(m == "simd_simple" || m == "simd_mixta" || m == "simd_incremental"){
+          const GridVector& simd_grid = simd_reference[omegas[r]];
+          double simd_difference = 0.0;
+          for(size_t k=0; k < grid.size(); ++k){
+            simd_difference = std::max(simd_difference, std::abs(grid[k] - simd_grid[k]));
+          }
+          std::cout << "; Diferencia con simd: " << simd_difference;
+        }
+        if(m == "simd_incremental"){
+          std::cout << "; Bloques omitidos: " << 100.0*skipped << "%; Ahorro de tiempo frente a simd: " << 100.0*(simd_time[omegas[r]] - elapsed)/simd_time[omegas[r]] << "%";
+        }
+        std::cout << std::endl;
+        if(omegas.size() > 1 && r == 0){
+          fixed_iterations = iterations;
+        } else if(omegas.size() > 1){
+          std::cout << "Ahorro de iteraciones con omega automático: " << 100.0*(fixed_iterations - iterations)/fixed_iterations << "%" << std::endl;
+        }
+      }
+    }
+    return 0;
+  }
+
+  GridVector grid = grid_generator(factor, volt1, volt2);
+  load_initial_state(checkpoint, grid, factor, volt1, volt2);
+  int iterations;
+  double time_1 = seconds();
+  if(method == "gauss_seidel"){
+    iterations = gauss_seidel(grid,omega, factor, tolerance, check_every, checkpoint);
+  } else if(method == "simd"){
+    iterations = simd(grid, omega, arithmetic, active);
+  } else{
+    iterations = multigrid(grid, mg_omega, factor, tolerance, method == "fmg");
+  }
+  double time_2 = seconds();
+  TELEMETRY_FINISH();
+  if(benchmark){
+    std::cout << "Tiempo transcurrido: " << time_2 - time_1 << std::endl;
+    std::cout << "Iteraciones: " << iterations << std::endl;
+    return 0;
+  }
+  print_grid(grid, factor, precision, output);
 }
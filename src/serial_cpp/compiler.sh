@@ -1,5 +1,5 @@
 #!/bin/bash
 
-g++ Capacitor.cpp
-./a.out > capacitor.csv
+g++ -O2 -I../common Capacitor.cpp
+./a.out "$@" > capacitor.csv
 python3 plot.py
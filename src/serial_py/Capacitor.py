@@ -249,11 +249,22 @@ main_grid = grid_generator(factor, V1, V2, boundary)
 #plt.tight_layout()
 #plt.title(f"Método de Jacobi. Iteraciones requeridas: {iterations}")
 #plt.show()
-gauss_vals, iterations = gauss_seidel(main_grid, omega, factor, tol)
+# Si está compilada la biblioteca compartida ('compiler.sh' o CMake), se resuelve con el solucionador rojo-negro de C++ sobre un numpy array, sin copias
+# (ver 'capacitor_lib.py'); de lo contrario se emplean los ciclos de Python de 'gauss_seidel'. Las iteraciones difieren, ya que el solucionador de C++ recorre la grilla en orden rojo-negro.
+try:
+    from capacitor_lib import CapacitorSolver
+    solver = CapacitorSolver(factor, V1, V2)
+    iterations = solver.solve(omega, tol)
+    gauss_vals = solver.phi
+    method = f"Gauss Seidel rojo-negro (libcapacitor, kernel {solver.kernel})"
+except OSError as error:
+    print(error)
+    gauss_vals, iterations = gauss_seidel(main_grid, omega, factor, tol)
+    method = "Gauss Seidel"
 end = time.time()
 print(end - start)
 plt.imshow(gauss_vals, cmap = "gray")
 plt.tight_layout()
-plt.title(f"Método de Gauss Seidel. Iteraciones requeridas: {iterations} \n Omega = {omega}")
+plt.title(f"Método de {method}. Iteraciones requeridas: {iterations} \n Omega = {omega}")
 plt.show()
 
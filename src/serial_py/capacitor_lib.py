@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+
+# Acceso desde Python a la biblioteca compartida 'libcapacitor' (interfaz en C de 'src/common/capacitor_api.h') mediante ctypes.
+# La grilla es un numpy array que pertenece a Python y que el solucionador de C++ actualiza directamente: no se copia ni se interpreta texto.
+# ctypes libera el GIL durante cada llamada a la biblioteca (ctypes.CDLL), por lo que otros hilos de Python continúan mientras se resuelve el capacitor.
+import ctypes
+import ctypes.util
+import os
+import numpy as np
+
+# Valor de 'omega' para escogerlo automáticamente (CAPACITOR_AUTO_OMEGA).
+AUTO_OMEGA = -1.0
+# Códigos de regreso de 'capacitor_solve' que no son errores.
+CAPACITOR_OK = 0
+CAPACITOR_NOT_CONVERGED = 1
+
+_lib = None
+
+def load_library(path = None):
+    """
+    Carga la biblioteca compartida y declara los tipos de sus funciones. Se busca, en orden: el argumento 'path', la variable de entorno CAPACITOR_LIB, 'libcapacitor.so' en esta carpeta (ver 'compiler.sh'),
+    en la carpeta de compilación de CMake 'build' de la raíz del repositorio y en las rutas del sistema.
+
+    Returns:
+        lib (ctypes.CDLL): La biblioteca cargada; las llamadas siguientes regresan la misma.
+    """
+    global _lib
+    if _lib is not None and path is None:
+        return _lib
+    here = os.path.dirname(os.path.abspath(__file__))
+    root = os.path.normpath(os.path.join(here, '..', '..'))
+    candidates = [path, os.environ.get('CAPACITOR_LIB'), os.path.join(here, 'libcapacitor.so'),
+                  os.path.join(root, 'build', 'libcapacitor.so'), ctypes.util.find_library('capacitor')]
+    for candidate in candidates:
+        if candidate and (os.path.exists(candidate) or not os.path.dirname(candidate)):
+            lib = ctypes.CDLL(candidate)
+            break
+    else:
+        raise OSError("No se encontró 'libcapacitor.so'; se debe compilar con 'compiler.sh' o con CMake, o indicar su ruta con CAPACITOR_LIB.")
+
+    double_p = ctypes.POINTER(ctypes.c_double)
+    solver_p = ctypes.c_void_p
+    lib.capacitor_api_version.restype = ctypes.c_int
+    lib.capacitor_api_version.argtypes = []
+    for name in ('capacitor_rows', 'capacitor_columns', 'capacitor_stride'):
+        getattr(lib, name).restype = ctypes.c_int
+        getattr(lib, name).argtypes = [ctypes.c_int]
+    lib.capacitor_buffer_size.restype = ctypes.c_size_t
+    lib.capacitor_buffer_size.argtypes = [ctypes.c_int]
+    lib.capacitor_create.restype = solver_p
+    lib.capacitor_create.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_double, double_p, ctypes.c_char_p, ctypes.POINTER(ctypes.c_int)]
+    lib.capacitor_solve.restype = ctypes.c_int
+    lib.capacitor_solve.argtypes = [solver_p, ctypes.c_double, ctypes.c_double, ctypes.c_int, ctypes.c_int]
+    lib.capacitor_data.restype = double_p
+    lib.capacitor_data.argtypes = [solver_p]
+    for name in ('capacitor_factor', 'capacitor_iterations', 'capacitor_threads'):
+        getattr(lib, name).restype = ctypes.c_int
+        getattr(lib, name).argtypes = [solver_p]
+    for name in ('capacitor_delta', 'capacitor_omega', 'capacitor_elapsed'):
+        getattr(lib, name).restype = ctypes.c_double
+        getattr(lib, name).argtypes = [solver_p]
+    lib.capacitor_kernel.restype = ctypes.c_char_p
+    lib.capacitor_kernel.argtypes = [solver_p]
+    lib.capacitor_destroy.restype = None
+    lib.capacitor_destroy.argtypes = [solver_p]
+    lib.capacitor_error.restype = ctypes.c_char_p
+    lib.capacitor_error.argtypes = [ctypes.c_int]
+    if lib.capacitor_api_version() < 1:
+        raise OSError("La versión de 'libcapacitor' no es compatible.")
+    _lib = lib
+    return lib
+
+def _check(lib, status):
+    if status < 0:
+        raise RuntimeError(lib.capacitor_error(status).decode())
+    return status
+
+class CapacitorSolver:
+    """
+    Solucionador rojo-negro vectorizado de la biblioteca sobre una grilla de numpy. El atributo 'phi' es la grilla de (10*factor)x(10*factor+1), una vista sin copia de la memoria rellena
+    que recorre el solucionador (cada fila inicia en un múltiplo de 64 bytes); se puede leer o modificar entre llamadas a 'solve', por ejemplo para fijar un valor inicial.
+
+    Examples:
+        >>> solver = CapacitorSolver(10)
+        >>> its = solver.solve(omega = 0.9, tol = 1e-4)
+        >>> plot(solver.phi)
+
+    Args:
+        factor (int): Factor de escala de la grilla.
+        V1 (float), V2 (float): Potenciales de las líneas en las columnas 2*factor y 8*factor.
+        kernel (str): 'auto', 'avx512', 'avx2' o 'scalar'.
+        lib (ctypes.CDLL): Biblioteca a emplear; por defecto la de 'load_library'.
+    """
+    def __init__(self, factor = 10, V1 = 1.0, V2 = -1.0, kernel = 'auto', lib = None):
+        self._lib = lib if lib is not None else load_library()
+        self._handle = None
+        factor = int(factor)
+        rows = self._lib.capacitor_rows(factor)
+        stride = self._lib.capacitor_stride(factor)
+        if rows == 0:
+            raise ValueError("El factor de escala debe ser un número entero mayor que cero!")
+        # Memoria rellena alineada a 64 bytes: se reserva una línea de caché adicional y se toma la vista que inicia alineada.
+        size = rows*stride
+        raw = np.zeros(size + 8, dtype = np.float64)
+        offset = (-raw.ctypes.data % 64)//8
+        self._buffer = raw[offset:offset + size].reshape(rows, stride)
+        status = ctypes.c_int(0)
+        self._handle = self._lib.capacitor_create(factor, V1, V2, self._buffer.ctypes.data_as(ctypes.POINTER(ctypes.c_double)), kernel.encode(), ctypes.byref(status))
+        if not self._handle:
+            _check(self._lib, status.value)
+        self.factor = factor
+        self.phi = self._buffer[:, :self._lib.capacitor_columns(factor)]
+
+    def solve(self, omega = 0.9, tol = 1e-4, check_every = 1, max_iterations = 0):
+        """
+        Itera sobre 'phi' hasta llegar a la tolerancia. La grilla se actualiza en su lugar y el GIL se libera durante el cálculo.
+
+        Args:
+            omega (float): Parámetro de sobre-relajación; AUTO_OMEGA lo escoge a partir del radio espectral de Jacobi.
+            tol (float): Tolerancia sobre la diferencia máxima de una iteración.
+            check_every (int): La convergencia se evalúa cada 'check_every' iteraciones.
+            max_iterations (int): Máximo de iteraciones (0 sin límite). Si se alcanza sin llegar a la tolerancia, 'converged' es falso.
+
+        Returns:
+            its (int): Iteraciones que fueron necesarias para llegar a la tolerancia especificada.
+        """
+        status = _check(self._lib, self._lib.capacitor_solve(self._handle, omega, tol, int(check_every), int(max_iterations)))
+        self.converged = (status == CAPACITOR_OK)
+        return self.iterations
+
+    @property
+    def iterations(self):
+        return self._lib.capacitor_iterations(self._handle)
+
+    @property
+    def delta(self):
+        return self._lib.capacitor_delta(self._handle)
+
+    @property
+    def omega(self):
+        return self._lib.capacitor_omega(self._handle)
+
+    @property
+    def elapsed(self):
+        return self._lib.capacitor_elapsed(self._handle)
+
+    @property
+    def threads(self):
+        return self._lib.capacitor_threads(self._handle)
+
+    @property
+    def kernel(self):
+        return self._lib.capacitor_kernel(self._handle).decode()
+
+    def close(self):
+        """
+        Libera el solucionador. 'phi' sigue siendo válido, ya que la memoria pertenece a numpy.
+        """
+        if self._handle:
+            self._lib.capacitor_destroy(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        self.close()
+
+def gauss_seidel(factor, omega = 0.9, tol = 1e-4, V1 = 1.0, V2 = -1.0, kernel = 'auto'):
+    """
+    Equivalente a 'gauss_seidel' de 'Capacitor.py' con el solucionador de C++: crea la grilla, la resuelve y la regresa.
+
+    Returns:
+        phi (Numpy array): La grilla de tamaño (10*factor, 10*factor+1) con la solución, sin copias de la memoria del solucionador.
+        its (int): Iteraciones que fueron necesarias para llegar a la tolerancia especificada.
+    """
+    solver = CapacitorSolver(factor, V1, V2, kernel)
+    its = solver.solve(omega, tol)
+    solver.close()
+    return solver.phi, its
@@ -0,0 +1,5 @@
+#!/bin/bash
+
+# Biblioteca compartida con la interfaz en C de 'src/common/capacitor_api.h', que 'capacitor_lib.py' carga desde esta carpeta.
+g++ -O2 -fopenmp -fPIC -shared -fvisibility=hidden -I../common ../common/capacitor_api.cpp -o libcapacitor.so
+python3 Capacitor.py
@@ -1,12 +1,35 @@
 #!/usr/bin/env python3
 
+import sys
 import matplotlib.pyplot as plt
-import pandas as pd
 import numpy as np
 
-file = pd.read_csv('capacitor.csv',delimiter=';', header=None)
+def plot(data, title = None):
+    """
+    Grafica una grilla que ya está en memoria, por ejemplo 'CapacitorSolver.phi' de 'capacitor_lib.py', sin escribirla a un archivo.
+    """
+    plt.imshow(np.asarray(data))
+    plt.gray()
+    if title:
+        plt.title(title)
+    plt.show()
 
-data = file.to_numpy(dtype=float)
-plt.imshow(data)
-plt.gray()
-plt.show()
+# Uso: 'python3 plot.py [archivo]' grafica el CSV (o '.npy') que escriben los solucionadores, 'capacitor.csv' si no se indica otro.
+# Con '--resolver' ('--factor N' y '--omega W' opcionales) se resuelve el capacitor con 'libcapacitor' y se grafica la grilla directamente desde la memoria del solucionador.
+if __name__ == '__main__':
+    args = sys.argv[1:]
+    if '--resolver' in args:
+        from capacitor_lib import CapacitorSolver
+        factor = int(args[args.index('--factor')+1]) if '--factor' in args else 10
+        omega = float(args[args.index('--omega')+1]) if '--omega' in args else 0.9
+        solver = CapacitorSolver(factor)
+        iterations = solver.solve(omega = omega, tol = 1e-4)
+        plot(solver.phi, f"Kernel {solver.kernel}. Iteraciones requeridas: {iterations} \n Omega = {solver.omega:.4f}")
+    else:
+        name = args[0] if args else 'capacitor.csv'
+        if name.endswith('.npy'):
+            data = np.load(name, mmap_mode='r')
+        else:
+            import pandas as pd
+            data = pd.read_csv(name, delimiter=';', header=None).to_numpy(dtype=float)
+        plot(data)